@@ -0,0 +1,75 @@
+#ifndef CAN_ARCHIVE_H
+#define CAN_ARCHIVE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "can_frame.h"
+
+// Columnar archive for long captures.
+// Frames are buffered per CAN ID and written as blocks; inside a block the
+// timestamps are one column (delta-of-delta, zigzag varints), the capture
+// sequence numbers another (gap to the previous frame of the ID, repeated
+// gaps run-length coded) and the payloads a third (XOR against the previous
+// frame, with runs of unchanged frames collapsed into a single count).
+// Payload bytes beyond the DLC are not stored. The reader merges the
+// per-ID blocks on sequence number, so it returns the original frame stream.
+//
+// File:  "CANARC\0\0" | u32 version
+// Block: u16 id | u16 frame count | u32 encoded size | timestamps | sequence | payloads
+#define ARC_MAGIC          "CANARC\0"
+#define ARC_VERSION        2
+#define ARC_ID_COUNT       2048
+#define ARC_BLOCK_FRAMES   256
+#define ARC_MAX_BLOCK_BYTES (ARC_BLOCK_FRAMES * 25)
+
+typedef struct {
+    FILE* file;
+    CANFrame* columns[ARC_ID_COUNT];    // Allocated on first use of an ID
+    uint64_t* sequence[ARC_ID_COUNT];
+    uint16_t fill[ARC_ID_COUNT];
+    uint8_t block[ARC_MAX_BLOCK_BYTES];
+    uint64_t frames;
+    uint64_t raw_bytes;                 // id + dlc + data + timestamp per frame
+    uint64_t encoded_bytes;
+} ARCWriter;
+
+// Per-ID read state: where its blocks are and the one currently decoded
+typedef struct {
+    int64_t* offsets;                   // Block header offsets, file order
+    int block_count;
+    int block_capacity;
+    int next_block;
+    int count;
+    int pos;
+    CANFrame frames[ARC_BLOCK_FRAMES];
+    uint64_t sequence[ARC_BLOCK_FRAMES];
+} ARCColumnReader;
+
+typedef struct {
+    FILE* file;
+    ARCColumnReader* columns[ARC_ID_COUNT]; // Allocated for IDs present in the file
+    uint16_t heap[ARC_ID_COUNT];        // IDs ordered by their next sequence number
+    int heap_size;
+    uint8_t block[ARC_MAX_BLOCK_BYTES];
+} ARCReader;
+
+// Block codec
+size_t ARC_EncodeBlock(const CANFrame* frames, const uint64_t* sequence, int count, uint8_t* out);
+int ARC_DecodeBlock(const uint8_t* in, size_t len, uint16_t id, CANFrame* frames,
+                    uint64_t* sequence, int count);
+
+// Streaming writer/reader
+bool ARC_OpenWriter(ARCWriter* writer, const char* filename);
+bool ARC_WriteFrame(ARCWriter* writer, const CANFrame* frame);
+void ARC_CloseWriter(ARCWriter* writer);
+bool ARC_OpenReader(ARCReader* reader, const char* filename);
+bool ARC_ReadFrame(ARCReader* reader, CANFrame* frame);  // Original capture order
+void ARC_CloseReader(ARCReader* reader);
+
+// Logging hook (same lifecycle as the JSON logger)
+void ARC_Init(const char* filename);
+void ARC_LogFrame(const CANFrame* frame);
+void ARC_Close(void);
+
+#endif
@@ -2,6 +2,7 @@
 #define CAN_BUS_H
 
 #include "can_frame.h"
+#include "can_error.h"
 #include <stdbool.h>
 
 #define MAX_BUS_QUEUE 100
@@ -15,6 +16,14 @@ typedef struct {
     uint32_t dropped_frames;
 } CANBusStats;
 
+// Delivery monitor, called for every frame delivered from the bus
+typedef void (*CANBusMonitor)(void* ctx, const CANFrame* frame);
+
+typedef struct {
+    CANBusMonitor fn;
+    void* ctx;
+} CANBusMonitorSlot;
+
 // Virtual CAN Bus
 typedef struct {
     CANFrame queue[MAX_BUS_QUEUE];
@@ -23,12 +32,20 @@ typedef struct {
     int queue_count;
     CANBusStats stats;
     bool bus_active;
+    bool verbose;                   // Print bus errors (off for high-rate runs)
+    CANBusMonitorSlot monitors[MAX_SUBSCRIBERS];
+    int monitor_count;
+    FaultInjector* faults;          // Corrupts ECU transmissions (may be NULL)
 } CANBus;
 
 // Bus operations
 void CANBus_Init(CANBus* bus);
 bool CANBus_Transmit(CANBus* bus, const CANFrame* frame);
 bool CANBus_Receive(CANBus* bus, CANFrame* frame);
+bool CANBus_ReceiveArbitrated(CANBus* bus, CANFrame* frame);  // Highest priority first
+bool CANBus_Retransmit(CANBus* bus, const CANFrame* frame);    // Requeue after an error frame
+void CANBus_Deliver(CANBus* bus, const CANFrame* frame);     // Run monitors
+bool CANBus_AttachMonitor(CANBus* bus, CANBusMonitor fn, void* ctx);
 bool CANBus_IsEmpty(const CANBus* bus);
 void CANBus_PrintStats(const CANBus* bus);
 void CANBus_Clear(CANBus* bus);
@@ -0,0 +1,71 @@
+#ifndef CAN_ERROR_H
+#define CAN_ERROR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "can_frame.h"
+
+// ISO 11898 error confinement
+//   TEC/REC <= 127          -> error-active
+//   TEC or REC > 127        -> error-passive
+//   TEC > 255               -> bus-off, until 128 sequences of
+//                              11 recessive bits have been seen
+#define CAN_ERROR_PASSIVE_LIMIT   127
+#define CAN_BUS_OFF_LIMIT         255
+#define CAN_BUS_OFF_RECOVERY      128
+
+// Worst-case bit-stuffed length of a standard data frame incl. interframe space
+#define CAN_FRAME_BITS(dlc)       (55u + 10u * (dlc))
+
+// Bus time of an error flag (6 + up to 6 echoed) plus delimiter (8) and
+// interframe space (3)
+#define CAN_ERROR_FRAME_BITS      23
+
+typedef enum {
+    CAN_ERROR_ACTIVE,
+    CAN_ERROR_PASSIVE,
+    CAN_BUS_OFF
+} CANErrorState;
+
+typedef struct {
+    uint16_t tec;                   // Transmit error counter
+    uint16_t rec;                   // Receive error counter
+    CANErrorState state;
+    uint16_t recovery_count;        // Recessive sequences seen while bus-off
+    uint32_t bus_off_events;
+} CANErrorCounters;
+
+typedef enum {
+    FAULT_NONE,
+    FAULT_BIT_ERROR,                // Corrupted bit, detected by all nodes
+    FAULT_ACK_ERROR                 // No receiver acknowledged the frame
+} FaultType;
+
+// Fault injector. Rates are turned into 32-bit thresholds up front so
+// each frame costs one RNG draw and a compare.
+typedef struct {
+    double bit_error_rate;          // Probability per transmitted bit
+    double ack_drop_rate;           // Probability per frame
+    uint32_t bit_threshold[CAN_MAX_DATA_LEN + 1];
+    uint32_t ack_threshold;
+    uint64_t rng;
+    uint64_t bit_errors;
+    uint64_t ack_errors;
+} FaultInjector;
+
+// Error confinement state machine
+void CANERR_Init(CANErrorCounters* err);
+void CANERR_OnTxSuccess(CANErrorCounters* err);
+void CANERR_OnTxError(CANErrorCounters* err, FaultType fault);
+void CANERR_OnRxSuccess(CANErrorCounters* err);
+void CANERR_OnRxError(CANErrorCounters* err);
+void CANERR_OnRecessiveSequence(CANErrorCounters* err, uint32_t count);
+bool CANERR_CanTransmit(const CANErrorCounters* err);
+const char* CANERR_StateName(CANErrorState state);
+
+// Fault injection
+void FAULT_Init(FaultInjector* inj, double bit_error_rate, double ack_drop_rate, uint64_t seed);
+FaultType FAULT_Inject(FaultInjector* inj, const CANFrame* frame, uint32_t frame_bits,
+                       uint32_t* error_bit);
+
+#endif
@@ -6,6 +6,7 @@
 
 // CAN 2.0B Standard (11-bit identifier)
 #define CAN_ID_BITS 11
+#define CAN_ID_COUNT (1 << CAN_ID_BITS)
 #define CAN_MAX_DATA_LEN 8
 
 // CAN Message Priority (lower ID = higher priority)
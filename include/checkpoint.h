@@ -0,0 +1,56 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "can_bus.h"
+#include "ecu_node.h"
+#include "dtc_manager.h"
+#include "ids_detector.h"
+#include "sim_env.h"
+
+// Checkpoint image layout: [CheckpointHeader][SimSnapshot]
+// The snapshot is stored as raw structs, so a restore is one mmap and
+// a handful of struct copies. Bump CHECKPOINT_VERSION whenever any of the
+// snapshotted structs change layout.
+#define CHECKPOINT_MAGIC     "CANSIMCK"
+#define CHECKPOINT_VERSION   8
+#define CHECKPOINT_MAX_ECUS  8
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t payload_size;
+    uint32_t checksum;        // FNV-1a over the payload
+    uint32_t reserved[2];     // Keeps the payload 8-byte aligned
+} CheckpointHeader;
+
+// Full simulation state
+typedef struct {
+    SimEnv env;
+    uint32_t cycle;
+    int ecu_count;
+    CANBus bus;
+    ECUNode ecus[CHECKPOINT_MAX_ECUS];
+    DTCManager dtc;
+    uint64_t fault_rng;             // Fault injector stream, 0 = no injector attached
+    uint64_t fault_bit_errors;
+    uint64_t fault_ack_errors;
+    bool ids_saved;                 // Detector attached when the image was taken
+    IDSDetector ids;                // Learned profiles and counters
+} SimSnapshot;
+
+// Checkpoint operations
+bool Checkpoint_Save(const char* filename, const SimSnapshot* snap);
+const SimSnapshot* Checkpoint_Map(const char* filename);
+void Checkpoint_Unmap(const SimSnapshot* snap);
+
+// Copy live state into / out of a snapshot (ids may be NULL)
+void Checkpoint_Capture(SimSnapshot* snap, const CANBus* bus, ECUNode* const ecus[],
+                        int ecu_count, const DTCManager* dtc, const IDSDetector* ids,
+                        uint32_t cycle);
+bool Checkpoint_Restore(const SimSnapshot* snap, CANBus* bus, ECUNode* ecus[],
+                        int ecu_count, DTCManager* dtc, IDSDetector* ids, uint32_t* cycle);
+
+#endif
@@ -13,6 +13,9 @@ typedef enum {
     DTC_ABS_MALFUNCTION         = 0xC0265,
     DTC_TRANSMISSION_SLIP       = 0x0730,
     DTC_SENSOR_COMMUNICATION    = 0xF100,  // Network/Communication code
+    DTC_NETWORK_UNKNOWN_ID      = 0xF101,  // Frame with an ID never seen in training
+    DTC_NETWORK_SPOOFED_FRAME   = 0xF102,  // DLC or payload outside learned profile
+    DTC_NETWORK_FLOODING        = 0xF103,  // ID arriving much faster than its period
     DTC_LOW_FUEL_PRESSURE       = 0x0087
 } DTCCode;
 
@@ -3,8 +3,10 @@
 
 #include "can_frame.h"
 #include "can_bus.h"
+#include "can_error.h"
 
 #define ECU_NAME_LEN 32
+#define ECU_MAX_TX_ATTEMPTS 32      // Back-to-back bit errors reach bus-off within this
 
 typedef enum {
     ECU_ENGINE_CONTROL,
@@ -20,11 +22,12 @@ typedef struct {
     uint32_t frames_sent;
     uint32_t frames_received;
     bool active;
+    CANErrorCounters err;           // Error confinement state
 } ECUNode;
 
 // ECU operations
 void ECU_Init(ECUNode* ecu, const char* name, ECUType type);
-void ECU_SendFrame(ECUNode* ecu, CANBus* bus, const CANFrame* frame);
+bool ECU_SendFrame(ECUNode* ecu, CANBus* bus, const CANFrame* frame);  // True once on the bus
 bool ECU_ReceiveFrame(ECUNode* ecu, CANBus* bus, CANFrame* frame);
 void ECU_PrintStats(const ECUNode* ecu);
 
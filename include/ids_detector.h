@@ -0,0 +1,61 @@
+#ifndef IDS_DETECTOR_H
+#define IDS_DETECTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "can_frame.h"
+#include "can_bus.h"
+#include "dtc_manager.h"
+
+// Streaming intrusion/anomaly detector.
+// One fixed 32-byte profile per 11-bit ID, learned from clean traffic:
+// DLC, minimum inter-arrival time and a model per payload byte. Bytes that
+// never changed while learning must keep their value (within a small guard
+// band); bytes that did change are checked by their step from the previous
+// accepted frame, so counters and drifting multi-byte signals that wrap
+// their low byte stay valid. After learning, each delivered frame is
+// checked with a table lookup and a few compares.
+// Timestamps are used as-is, so the detector works with ms or us clocks.
+#define IDS_TABLE_SIZE      CAN_ID_COUNT
+#define IDS_FLOOD_THRESHOLD 8       // Leaky bucket level that counts as flooding
+
+typedef enum {
+    IDS_OK,
+    IDS_UNKNOWN_ID,                 // Injected: ID never seen while learning
+    IDS_DLC_MISMATCH,               // Spoofed: wrong length for this ID
+    IDS_PAYLOAD_RANGE,              // Spoofed: byte outside learned range
+    IDS_FLOOD,                      // Flooding: arriving under half the period
+    IDS_VERDICT_COUNT
+} IDSVerdict;
+
+typedef struct {
+    uint8_t ref[CAN_MAX_DATA_LEN];  // Learned value, or last accepted value of a tracked byte
+    uint8_t limit[CAN_MAX_DATA_LEN];// Largest accepted (wrapping) distance from ref
+    uint32_t last_ts;               // Last on-time frame
+    uint32_t prev_ts;               // On-time frame before it
+    uint32_t min_period;
+    uint8_t flood_level;
+    uint8_t dlc;
+    uint8_t flags;
+    uint8_t tracked;                // Bit per byte: changed while learning
+} IDSProfile;
+
+typedef struct {
+    IDSProfile table[IDS_TABLE_SIZE];
+    bool learning;
+    uint64_t learn_frames;          // Learning ends after this many frames, 0 = IDS_EndLearning
+    DTCManager* dtc;                // DTCs are raised here (may be NULL)
+    uint32_t dtc_raised;            // Bit per verdict, each DTC raised once
+    uint64_t frames;
+    uint64_t alerts[IDS_VERDICT_COUNT];
+} IDSDetector;
+
+// Detector operations
+void IDS_Init(IDSDetector* ids, DTCManager* dtc, uint64_t learn_frames);
+void IDS_EndLearning(IDSDetector* ids);
+IDSVerdict IDS_Inspect(IDSDetector* ids, const CANFrame* frame);
+void IDS_Monitor(void* ctx, const CANFrame* frame);     // CANBusMonitor adapter
+const char* IDS_VerdictName(IDSVerdict verdict);
+void IDS_PrintStats(const IDSDetector* ids);
+
+#endif
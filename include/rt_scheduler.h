@@ -0,0 +1,52 @@
+#ifndef RT_SCHEDULER_H
+#define RT_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <signal.h>
+
+// Soft real-time pacing for periodic CAN messages.
+// Each message gets its own timerfd with an absolute start time; all timers
+// are multiplexed in one epoll loop. Release jitter is measured against the
+// ideal release instant, and the deadline is the message period.
+// Only available on Linux; RT_Run() fails elsewhere.
+#define RT_MAX_TASKS 16
+#define RT_TASK_NAME_LEN 32
+
+// Called at every release with the ideal release time (CLOCK_MONOTONIC ns)
+typedef void (*RTReleaseFn)(void* ctx, uint64_t release_ns);
+
+typedef struct {
+    char name[RT_TASK_NAME_LEN];
+    uint16_t can_id;
+    uint32_t period_us;
+    RTReleaseFn release;
+    void* ctx;
+
+    // Measurements
+    uint64_t releases;
+    uint64_t deadline_misses;       // Late completions plus skipped releases
+    int64_t jitter_min_ns;
+    int64_t jitter_max_ns;
+    int64_t jitter_sum_ns;
+
+    // Runtime
+    uint64_t next_release_ns;
+    int fd;
+} RTTask;
+
+typedef struct {
+    RTTask tasks[RT_MAX_TASKS];
+    int task_count;
+    int cpu;                        // CPU to pin to, -1 = no pinning
+    int fifo_priority;              // SCHED_FIFO priority, 0 = normal scheduling
+} RTScheduler;
+
+// Scheduler operations
+void RT_Init(RTScheduler* sched, int cpu, int fifo_priority);
+bool RT_AddTask(RTScheduler* sched, const char* name, uint16_t can_id,
+                uint32_t period_us, RTReleaseFn release, void* ctx);
+bool RT_Run(RTScheduler* sched, uint32_t duration_ms, volatile sig_atomic_t* keep_running);
+void RT_PrintStats(const RTScheduler* sched);
+
+#endif
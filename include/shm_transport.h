@@ -0,0 +1,81 @@
+#ifndef SHM_TRANSPORT_H
+#define SHM_TRANSPORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "can_frame.h"
+#include "can_bus.h"
+
+// Shared-memory bus transport, so ECUs in other processes can attach.
+// One POSIX shm segment holds two lock-free rings:
+//   TX: clients -> simulator, multi-producer (per-slot sequence numbers)
+//   RX: simulator -> clients, single-producer broadcast; each client keeps
+//       its own read position and detects overruns
+// Frames are written and read in place (zero copy). Waiting uses futexes
+// on the ring counters, so wakeups work across processes.
+// The server refuses to take over a segment whose owner is still running,
+// and removes it when the owner is gone (crash, kill -9). A TX slot left
+// reserved but uncommitted (client died in between) is reclaimed after
+// SHM_TX_ABANDON_MS; a late commit to it fails instead of corrupting the ring.
+// Linux only; other platforms fail at create/attach.
+#define SHM_MAGIC      0x4E414353u     // "SCAN"
+#define SHM_VERSION    2
+#define SHM_RING_SIZE  1024            // Power of two
+#define SHM_NAME_LEN   64
+#define SHM_TX_ABANDON_MS 500          // Reserved slot timeout before reclaim
+
+typedef struct {
+    uint32_t seq;
+    uint32_t reserved;
+    CANFrame frame;
+} SHMSlot;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t ring_size;
+    uint32_t frame_size;
+    uint32_t server_pid;            // Owner, for stale segment detection
+
+    // Counters live on separate cache lines to avoid false sharing
+    uint32_t tx_head __attribute__((aligned(64)));   // Next slot to reserve
+    uint32_t tx_tail __attribute__((aligned(64)));   // Next slot the server reads
+    uint32_t tx_signal;                              // Futex: bumped on commit
+    uint32_t tx_waiters;
+    uint32_t rx_head __attribute__((aligned(64)));   // Futex: frames published
+    uint32_t rx_waiters;
+
+    SHMSlot tx[SHM_RING_SIZE] __attribute__((aligned(64)));
+    SHMSlot rx[SHM_RING_SIZE] __attribute__((aligned(64)));
+} SHMSegment;
+
+typedef struct {
+    SHMSegment* seg;
+    char name[SHM_NAME_LEN];
+    bool server;
+    uint32_t rx_pos;                // Client read position
+    uint64_t rx_lost;               // Frames overwritten before they were read
+    bool tx_stalled;                // Server: TX tail slot reserved, not committed
+    uint32_t tx_stalled_pos;
+    uint64_t tx_stalled_since_ms;
+    uint64_t tx_abandoned;          // Server: reservations reclaimed after timeout
+} SHMTransport;
+
+// Simulator side
+bool SHM_ServerCreate(SHMTransport* shm, const char* name);
+bool SHM_ServerPoll(SHMTransport* shm, CANFrame* frame);     // Next client frame
+bool SHM_ServerWait(SHMTransport* shm, int timeout_ms);      // Block for client frames
+void SHM_ServerPublish(SHMTransport* shm, const CANFrame* frame);
+void SHM_Monitor(void* ctx, const CANFrame* frame);          // CANBusMonitor adapter
+
+// Client side
+bool SHM_ClientAttach(SHMTransport* shm, const char* name);
+CANFrame* SHM_TxReserve(SHMTransport* shm, uint32_t* ticket); // Fill in place...
+bool SHM_TxCommit(SHMTransport* shm, uint32_t ticket);        // ...then publish
+bool SHM_Transmit(SHMTransport* shm, const CANFrame* frame);
+const CANFrame* SHM_RxPeek(SHMTransport* shm, int timeout_ms); // NULL only on timeout
+bool SHM_RxRelease(SHMTransport* shm);  // False if overwritten while in use
+
+void SHM_Close(SHMTransport* shm);
+
+#endif
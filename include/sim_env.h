@@ -0,0 +1,28 @@
+#ifndef SIM_ENV_H
+#define SIM_ENV_H
+
+#include <stdint.h>
+
+// Simulation environment: deterministic RNG and virtual clock.
+// All randomness and timestamps go through here (instead of rand()/time())
+// so a run can be checkpointed and resumed bit-for-bit.
+#define SIM_RAND_MAX 0x7FFFFFFF
+
+typedef struct {
+    uint64_t clock_ms;    // Virtual time (Unix milliseconds when started from the wall clock)
+    uint32_t rng_state;   // xorshift32 state (never zero)
+    uint32_t reserved;
+} SimEnv;
+
+void SIM_Init(uint32_t seed, uint64_t start_ms);
+void SIM_Seed(uint32_t seed);
+int SIM_Rand(void);                 // 0..SIM_RAND_MAX, drop-in for rand()
+uint32_t SIM_GetTimeMs(void);       // Frame timestamps: low 32 bits, wraps
+uint64_t SIM_GetTimeMs64(void);     // Full clock, for wall-clock style stamps
+void SIM_AdvanceTime(uint32_t ms);
+
+// State access for checkpoint/restore
+void SIM_GetState(SimEnv* env);
+void SIM_SetState(const SimEnv* env);
+
+#endif
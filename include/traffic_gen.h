@@ -0,0 +1,108 @@
+#ifndef TRAFFIC_GEN_H
+#define TRAFFIC_GEN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "can_frame.h"
+#include "can_bus.h"
+#include "ecu_node.h"
+#include "can_error.h"
+
+// High-rate traffic generator for bus saturation tests.
+// Streams are released on a simulated nanosecond timeline; the load test
+// then serialises them onto a bus of the configured bitrate, always
+// sending the lowest pending ID next (CAN arbitration). With a fault
+// injector attached, failed attempts cost an error frame and are retried,
+// and each stream's transmitting node runs the error confinement rules.
+#define TGEN_MAX_STREAMS      64
+#define TGEN_DEFAULT_BITRATE  500000
+#define TGEN_PRIORITY_CLASSES 4
+#define TGEN_RAMP_RANGE       0x200
+
+typedef enum {
+    TGEN_PERIODIC,                  // Fixed period
+    TGEN_BURSTY,                    // burst_len frames back-to-back, same average rate
+    TGEN_POISSON                    // Exponential inter-arrival times
+} TGenMode;
+
+typedef enum {
+    TGEN_PAYLOAD_CONSTANT,          // Never changes (door/brake status style)
+    TGEN_PAYLOAD_COUNTER,           // Rolling counter in byte 0
+    TGEN_PAYLOAD_RAMP,              // 16-bit value drifting within +/-TGEN_RAMP_RANGE (RPM style)
+    TGEN_PAYLOAD_RANDOM             // Fresh random bytes every frame
+} TGenPayload;
+
+typedef struct {
+    uint16_t id;
+    uint8_t dlc;
+    TGenMode mode;
+    TGenPayload payload;
+    double rate_hz;                 // Average frames per second
+    uint16_t burst_len;
+    uint8_t node;                   // Index of the transmitting ECU
+
+    // Runtime
+    uint64_t next_ns;
+    uint64_t interval_ns;
+    uint16_t burst_left;
+    uint16_t ramp_base;
+    uint8_t data[CAN_MAX_DATA_LEN];
+    uint64_t pending_ns[MAX_BUS_QUEUE]; // Release times of this ID's queued frames (FIFO)
+    int pending_head;
+    int pending_count;
+} TGenStream;
+
+typedef struct {
+    TGenStream streams[TGEN_MAX_STREAMS];
+    int stream_count;
+    uint32_t bitrate;
+    uint64_t rng;
+    uint8_t id_node[CAN_ID_COUNT];  // Transmitting node per CAN ID
+    uint8_t id_stream[CAN_ID_COUNT];// First stream per CAN ID (owns the pending times)
+} TrafficGen;
+
+typedef struct {
+    uint64_t frames;
+    uint64_t latency_sum_us;
+    uint64_t latency_max_us;
+} TGenLatency;
+
+typedef struct {
+    double offered_load;            // Requested bus utilisation (1.0 = 100%)
+    double carried_load;            // Share of time the bus was busy
+    uint64_t generated;
+    uint64_t delivered;
+    uint32_t dropped;               // From CANBusStats
+    int max_queue_depth;
+    double avg_queue_depth;         // Sampled at each release
+    TGenLatency latency[TGEN_PRIORITY_CLASSES];
+    uint64_t error_frames;          // Failed attempts, each one retransmitted
+    uint64_t error_bus_ns;          // Bus time spent on failed attempts
+    uint64_t bus_off_drops;         // Frames discarded by bus-off nodes
+    uint32_t bus_off_events;
+    uint64_t duration_ns;
+} TGenReport;
+
+// Generator setup
+void TGEN_Init(TrafficGen* gen, uint32_t bitrate, uint64_t seed);
+bool TGEN_AddStream(TrafficGen* gen, uint16_t id, uint8_t dlc, TGenMode mode,
+                    TGenPayload payload, double rate_hz, uint16_t burst_len, uint8_t node);
+bool TGEN_AddStreamSpec(TrafficGen* gen, const char* spec);  // "id:dlc:mode:rate:payload[:burst[:node]]"
+void TGEN_AddDefaultStreams(TrafficGen* gen);
+double TGEN_OfferedLoad(const TrafficGen* gen);
+void TGEN_ScaleToUtilisation(TrafficGen* gen, double target);
+void TGEN_Reset(TrafficGen* gen);
+
+// Frame generation: next frame in release order, timestamp in microseconds
+void TGEN_Next(TrafficGen* gen, CANFrame* frame, uint64_t* release_ns);
+uint32_t TGEN_FrameBits(uint8_t dlc);
+int TGEN_PriorityClass(uint16_t id);
+
+// Saturation test
+// faults and nodes may be NULL for an error-free bus
+void TGEN_RunLoadTest(TrafficGen* gen, CANBus* bus, FaultInjector* faults,
+                      ECUNode* nodes, int node_count, uint64_t duration_ns, TGenReport* report);
+void TGEN_PrintReportHeader(void);
+void TGEN_PrintReport(const TGenReport* report);
+
+#endif
@@ -0,0 +1,512 @@
+#define _FILE_OFFSET_BITS 64             // 64-bit off_t for fseeko on 32-bit Linux
+#include "can_archive.h"
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+static ARCWriter* log_writer = NULL;
+
+// ---- Varint helpers (LEB128, zigzag for signed values) ----
+
+static uint8_t* put_varint(uint8_t* p, uint64_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static const uint8_t* get_varint(const uint8_t* p, const uint8_t* end, uint64_t* v) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *v = result;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+// Control byte: DLC in bits 0-3, RTR in bit 4, error flag in bit 5
+static uint8_t frame_ctrl(const CANFrame* frame) {
+    return (uint8_t)((frame->dlc & 0x0F) | (frame->rtr ? 0x10 : 0) | (frame->error ? 0x20 : 0));
+}
+
+static bool same_payload(const CANFrame* a, const CANFrame* b) {
+    return frame_ctrl(a) == frame_ctrl(b) && memcmp(a->data, b->data, a->dlc) == 0;
+}
+
+// ---- Block codec ----
+
+size_t ARC_EncodeBlock(const CANFrame* frames, const uint64_t* sequence, int count, uint8_t* out) {
+    uint8_t* p = out;
+
+    // Timestamp column: first value, first delta, then delta-of-delta
+    int64_t prev_delta = 0;
+    for (int i = 0; i < count; i++) {
+        if (i == 0) {
+            p = put_varint(p, frames[0].timestamp);
+            continue;
+        }
+        int64_t delta = (int32_t)(frames[i].timestamp - frames[i - 1].timestamp);
+        p = put_varint(p, zigzag(delta - prev_delta));
+        prev_delta = delta;
+    }
+
+    // Sequence column: first number, then the gap to the previous frame;
+    // odd token = new gap, even token = run of the previous gap
+    p = put_varint(p, sequence[0]);
+    uint64_t gap = 0;
+    uint64_t run = 0;
+    for (int i = 1; i < count; i++) {
+        uint64_t next = sequence[i] - sequence[i - 1];
+        if (next == gap) {
+            run++;
+            continue;
+        }
+        if (run > 0) {
+            p = put_varint(p, run << 1);
+            run = 0;
+        }
+        p = put_varint(p, (next << 1) | 1);
+        gap = next;
+    }
+    if (run > 0) {
+        p = put_varint(p, run << 1);
+        run = 0;
+    }
+
+    // Payload column: even token = run of unchanged frames,
+    // odd token = new control byte, then change mask and XOR bytes
+    CANFrame prev;
+    memset(&prev, 0, sizeof(prev));
+    for (int i = 0; i < count; i++) {
+        const CANFrame* frame = &frames[i];
+        if (i > 0 && same_payload(frame, &prev)) {
+            run++;
+            continue;
+        }
+        if (run > 0) {
+            p = put_varint(p, run << 1);
+            run = 0;
+        }
+
+        p = put_varint(p, ((uint64_t)frame_ctrl(frame) << 1) | 1);
+        uint8_t* mask = p++;
+        *mask = 0;
+        for (int b = 0; b < frame->dlc; b++) {
+            uint8_t x = frame->data[b] ^ prev.data[b];
+            if (x) {
+                *mask |= (uint8_t)(1u << b);
+                *p++ = x;
+            }
+        }
+        prev = *frame;
+        memset(prev.data + prev.dlc, 0, CAN_MAX_DATA_LEN - prev.dlc);
+    }
+    if (run > 0) {
+        p = put_varint(p, run << 1);
+    }
+
+    return (size_t)(p - out);
+}
+
+int ARC_DecodeBlock(const uint8_t* in, size_t len, uint16_t id, CANFrame* frames,
+                    uint64_t* sequence, int count) {
+    const uint8_t* p = in;
+    const uint8_t* end = in + len;
+    uint64_t v;
+
+    int64_t delta = 0;
+    for (int i = 0; i < count; i++) {
+        if (!(p = get_varint(p, end, &v))) return -1;
+        memset(&frames[i], 0, sizeof(CANFrame));
+        frames[i].id = id;
+        if (i == 0) {
+            frames[0].timestamp = (uint32_t)v;
+        } else {
+            delta += unzigzag(v);
+            frames[i].timestamp = frames[i - 1].timestamp + (uint32_t)delta;
+        }
+    }
+
+    if (!(p = get_varint(p, end, &v))) return -1;
+    sequence[0] = v;
+    uint64_t gap = 0;
+    int i = 1;
+    while (i < count) {
+        if (!(p = get_varint(p, end, &v))) return -1;
+
+        if ((v & 1) == 0) {
+            uint64_t run = v >> 1;
+            if (gap == 0 || run == 0 || run > (uint64_t)(count - i)) return -1;
+            for (; run > 0; run--, i++) {
+                sequence[i] = sequence[i - 1] + gap;
+            }
+            continue;
+        }
+        gap = v >> 1;
+        if (gap == 0) return -1;
+        sequence[i] = sequence[i - 1] + gap;
+        i++;
+    }
+
+    CANFrame prev;
+    memset(&prev, 0, sizeof(prev));
+    i = 0;
+    while (i < count) {
+        if (!(p = get_varint(p, end, &v))) return -1;
+
+        if ((v & 1) == 0) {
+            uint64_t run = v >> 1;
+            if (i == 0 || run == 0 || run > (uint64_t)(count - i)) return -1;
+            for (; run > 0; run--, i++) {
+                uint32_t ts = frames[i].timestamp;
+                frames[i] = prev;
+                frames[i].timestamp = ts;
+            }
+            continue;
+        }
+
+        uint8_t ctrl = (uint8_t)(v >> 1);
+        if (p >= end || (ctrl & 0x0F) > CAN_MAX_DATA_LEN) return -1;
+        uint8_t mask = *p++;
+        CANFrame* frame = &frames[i];
+        frame->dlc = ctrl & 0x0F;
+        frame->rtr = (ctrl & 0x10) != 0;
+        frame->error = (ctrl & 0x20) != 0;
+        for (int b = 0; b < frame->dlc; b++) {
+            uint8_t x = 0;
+            if (mask & (1u << b)) {
+                if (p >= end) return -1;
+                x = *p++;
+            }
+            frame->data[b] = prev.data[b] ^ x;
+        }
+        prev = *frame;
+        i++;
+    }
+
+    return (p == end) ? count : -1;
+}
+
+// ---- Streaming writer ----
+
+static bool flush_column(ARCWriter* writer, uint16_t id) {
+    int count = writer->fill[id];
+    if (count == 0) return true;
+
+    size_t size = ARC_EncodeBlock(writer->columns[id], writer->sequence[id], count, writer->block);
+    uint8_t hdr[8];
+    put_u16(hdr, id);
+    put_u16(hdr + 2, (uint16_t)count);
+    put_u32(hdr + 4, (uint32_t)size);
+
+    writer->fill[id] = 0;
+    writer->encoded_bytes += sizeof(hdr) + size;
+    return fwrite(hdr, sizeof(hdr), 1, writer->file) == 1 &&
+           fwrite(writer->block, 1, size, writer->file) == size;
+}
+
+bool ARC_OpenWriter(ARCWriter* writer, const char* filename) {
+    memset(writer, 0, sizeof(ARCWriter));
+    writer->file = fopen(filename, "wb");
+    if (!writer->file) {
+        printf("[ARC] Error: Cannot open %s for writing\n", filename);
+        return false;
+    }
+
+    uint8_t hdr[12];
+    memcpy(hdr, ARC_MAGIC, 8);
+    put_u32(hdr + 8, ARC_VERSION);
+    // Flushed at once, so a full or read-only target fails here
+    if (fwrite(hdr, sizeof(hdr), 1, writer->file) != 1 || fflush(writer->file) != 0) {
+        printf("[ARC] Error: Failed writing %s\n", filename);
+        fclose(writer->file);
+        writer->file = NULL;
+        return false;
+    }
+    writer->encoded_bytes = sizeof(hdr);
+    return true;
+}
+
+bool ARC_WriteFrame(ARCWriter* writer, const CANFrame* frame) {
+    uint16_t id = frame->id & 0x7FF;
+    if (!writer->columns[id]) {
+        writer->columns[id] = (CANFrame*)malloc(sizeof(CANFrame) * ARC_BLOCK_FRAMES);
+        writer->sequence[id] = (uint64_t*)malloc(sizeof(uint64_t) * ARC_BLOCK_FRAMES);
+        if (!writer->columns[id] || !writer->sequence[id]) {
+            free(writer->columns[id]);
+            free(writer->sequence[id]);
+            writer->columns[id] = NULL;
+            writer->sequence[id] = NULL;
+            return false;
+        }
+    }
+
+    writer->sequence[id][writer->fill[id]] = writer->frames++;
+    writer->columns[id][writer->fill[id]++] = *frame;
+    writer->raw_bytes += 2 + 1 + frame->dlc + 4;
+
+    if (writer->fill[id] == ARC_BLOCK_FRAMES) {
+        return flush_column(writer, id);
+    }
+    return true;
+}
+
+void ARC_CloseWriter(ARCWriter* writer) {
+    bool ok = true;
+    for (int id = 0; id < ARC_ID_COUNT; id++) {
+        if (writer->columns[id]) {
+            if (writer->file && !flush_column(writer, (uint16_t)id)) ok = false;
+            free(writer->columns[id]);
+            free(writer->sequence[id]);
+            writer->columns[id] = NULL;
+            writer->sequence[id] = NULL;
+        }
+    }
+    if (writer->file) {
+        if (fclose(writer->file) != 0) ok = false;
+        writer->file = NULL;
+        if (!ok) printf("[ARC] Error: Failed writing archive\n");
+    }
+}
+
+// ---- Streaming reader ----
+// Opening indexes every block by ID. Reading keeps one decoded block per ID
+// and a min-heap of IDs on the sequence number of their next frame.
+
+static uint64_t heap_key(const ARCReader* reader, int i) {
+    const ARCColumnReader* col = reader->columns[reader->heap[i]];
+    return col->sequence[col->pos];
+}
+
+static void heap_swap(ARCReader* reader, int a, int b) {
+    uint16_t tmp = reader->heap[a];
+    reader->heap[a] = reader->heap[b];
+    reader->heap[b] = tmp;
+}
+
+static void sift_up(ARCReader* reader, int i) {
+    while (i > 0 && heap_key(reader, i) < heap_key(reader, (i - 1) / 2)) {
+        heap_swap(reader, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static void sift_down(ARCReader* reader, int i) {
+    for (;;) {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < reader->heap_size && heap_key(reader, left) < heap_key(reader, smallest)) {
+            smallest = left;
+        }
+        if (right < reader->heap_size && heap_key(reader, right) < heap_key(reader, smallest)) {
+            smallest = right;
+        }
+        if (smallest == i) return;
+        heap_swap(reader, i, smallest);
+        i = smallest;
+    }
+}
+
+// 64-bit file positions: long is 32-bit on Windows, and soak archives pass 2 GB
+static int64_t file_tell(FILE* file) {
+#ifdef _WIN32
+    return _ftelli64(file);
+#else
+    return (int64_t)ftello(file);
+#endif
+}
+
+static int file_seek(FILE* file, int64_t offset, int whence) {
+#ifdef _WIN32
+    return _fseeki64(file, offset, whence);
+#else
+    return fseeko(file, (off_t)offset, whence);
+#endif
+}
+
+static bool index_block(ARCReader* reader, uint16_t id, int64_t offset) {
+    ARCColumnReader* col = reader->columns[id];
+    if (!col) {
+        col = (ARCColumnReader*)calloc(1, sizeof(ARCColumnReader));
+        if (!col) return false;
+        reader->columns[id] = col;
+    }
+    if (col->block_count == col->block_capacity) {
+        int capacity = col->block_capacity ? col->block_capacity * 2 : 16;
+        int64_t* offsets = (int64_t*)realloc(col->offsets, sizeof(int64_t) * capacity);
+        if (!offsets) return false;
+        col->offsets = offsets;
+        col->block_capacity = capacity;
+    }
+    col->offsets[col->block_count++] = offset;
+    return true;
+}
+
+// Decode the next block of an ID. On a corrupt block the whole read stops.
+static bool load_block(ARCReader* reader, uint16_t id) {
+    ARCColumnReader* col = reader->columns[id];
+    if (col->next_block == col->block_count) return false;
+
+    uint8_t hdr[8];
+    uint32_t size = 0;
+    int count = 0;
+    bool ok = file_seek(reader->file, col->offsets[col->next_block++], SEEK_SET) == 0 &&
+              fread(hdr, sizeof(hdr), 1, reader->file) == 1;
+    if (ok) {
+        count = get_u16(hdr + 2);
+        size = get_u32(hdr + 4);
+        ok = fread(reader->block, 1, size, reader->file) == size &&
+             ARC_DecodeBlock(reader->block, size, id, col->frames, col->sequence, count) == count;
+    }
+    if (!ok) {
+        printf("[ARC] Error: Corrupt block in archive\n");
+        reader->heap_size = 0;
+        return false;
+    }
+    col->count = count;
+    col->pos = 0;
+    return true;
+}
+
+bool ARC_OpenReader(ARCReader* reader, const char* filename) {
+    memset(reader, 0, sizeof(ARCReader));
+    reader->file = fopen(filename, "rb");
+    if (!reader->file) {
+        printf("[ARC] Error: Cannot open %s\n", filename);
+        return false;
+    }
+
+    uint8_t hdr[12];
+    if (fread(hdr, sizeof(hdr), 1, reader->file) != 1 ||
+        memcmp(hdr, ARC_MAGIC, 8) != 0 || get_u32(hdr + 8) != ARC_VERSION) {
+        printf("[ARC] Error: %s is not a version %d archive\n", filename, ARC_VERSION);
+        ARC_CloseReader(reader);
+        return false;
+    }
+
+    // Index pass over the block headers
+    for (;;) {
+        int64_t offset = file_tell(reader->file);
+        uint8_t block_hdr[8];
+        if (offset < 0 || fread(block_hdr, sizeof(block_hdr), 1, reader->file) != 1) break;
+
+        uint16_t id = get_u16(block_hdr);
+        int count = get_u16(block_hdr + 2);
+        uint32_t size = get_u32(block_hdr + 4);
+        if (id >= ARC_ID_COUNT || count == 0 || count > ARC_BLOCK_FRAMES ||
+            size > ARC_MAX_BLOCK_BYTES || file_seek(reader->file, size, SEEK_CUR) != 0 ||
+            !index_block(reader, id, offset)) {
+            printf("[ARC] Error: Corrupt block in archive\n");
+            ARC_CloseReader(reader);
+            return false;
+        }
+    }
+
+    for (int id = 0; id < ARC_ID_COUNT; id++) {
+        if (!reader->columns[id]) continue;
+        if (!load_block(reader, (uint16_t)id)) {
+            ARC_CloseReader(reader);
+            return false;
+        }
+        reader->heap[reader->heap_size++] = (uint16_t)id;
+        sift_up(reader, reader->heap_size - 1);
+    }
+    return true;
+}
+
+bool ARC_ReadFrame(ARCReader* reader, CANFrame* frame) {
+    if (!reader->file || reader->heap_size == 0) return false;
+
+    uint16_t id = reader->heap[0];
+    ARCColumnReader* col = reader->columns[id];
+    *frame = col->frames[col->pos++];
+
+    if (col->pos == col->count && !load_block(reader, id)) {
+        if (reader->heap_size > 0) {
+            reader->heap[0] = reader->heap[--reader->heap_size];
+        }
+    }
+    if (reader->heap_size > 0) {
+        sift_down(reader, 0);
+    }
+    return true;
+}
+
+void ARC_CloseReader(ARCReader* reader) {
+    for (int id = 0; id < ARC_ID_COUNT; id++) {
+        if (reader->columns[id]) {
+            free(reader->columns[id]->offsets);
+            free(reader->columns[id]);
+            reader->columns[id] = NULL;
+        }
+    }
+    reader->heap_size = 0;
+    if (reader->file) {
+        fclose(reader->file);
+        reader->file = NULL;
+    }
+}
+
+// ---- Logging hook ----
+
+void ARC_Init(const char* filename) {
+    log_writer = (ARCWriter*)malloc(sizeof(ARCWriter));
+    if (log_writer && !ARC_OpenWriter(log_writer, filename)) {
+        free(log_writer);
+        log_writer = NULL;
+    }
+}
+
+void ARC_LogFrame(const CANFrame* frame) {
+    if (!log_writer) return;
+    ARC_WriteFrame(log_writer, frame);
+}
+
+void ARC_Close(void) {
+    if (!log_writer) return;
+
+    ARC_CloseWriter(log_writer);
+    printf("[ARC] Archived %llu frames: %llu raw bytes -> %llu bytes (%.1fx)\n",
+           (unsigned long long)log_writer->frames,
+           (unsigned long long)log_writer->raw_bytes,
+           (unsigned long long)log_writer->encoded_bytes,
+           log_writer->encoded_bytes ?
+               (double)log_writer->raw_bytes / (double)log_writer->encoded_bytes : 0.0);
+    free(log_writer);
+    log_writer = NULL;
+}
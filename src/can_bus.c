@@ -5,24 +5,25 @@
 void CANBus_Init(CANBus* bus) {
     memset(bus, 0, sizeof(CANBus));
     bus->bus_active = true;
+    bus->verbose = true;
 }
 
 bool CANBus_Transmit(CANBus* bus, const CANFrame* frame) {
     if (!bus->bus_active) {
-        printf("[BUS] Error: Bus is inactive\n");
+        if (bus->verbose) printf("[BUS] Error: Bus is inactive\n");
         bus->stats.errors++;
         return false;
     }
     
     if (!CAN_ValidateFrame(frame)) {
-        printf("[BUS] Error: Invalid frame\n");
+        if (bus->verbose) printf("[BUS] Error: Invalid frame\n");
         bus->stats.errors++;
         return false;
     }
     
     // Check if queue is full
     if (bus->queue_count >= MAX_BUS_QUEUE) {
-        printf("[BUS] Error: Queue full, frame dropped\n");
+        if (bus->verbose) printf("[BUS] Error: Queue full, frame dropped\n");
         bus->stats.dropped_frames++;
         return false;
     }
@@ -46,6 +47,68 @@ bool CANBus_Receive(CANBus* bus, CANFrame* frame) {
     bus->queue_head = (bus->queue_head + 1) % MAX_BUS_QUEUE;
     bus->queue_count--;
     
+    CANBus_Deliver(bus, frame);
+    return true;
+}
+
+// Remove the pending frame that would win arbitration (lowest ID).
+// Frames behind it shift up one slot so the rest keep their queue order.
+bool CANBus_ReceiveArbitrated(CANBus* bus, CANFrame* frame) {
+    if (bus->queue_count == 0) {
+        return false;
+    }
+    
+    int winner = bus->queue_head;
+    int idx = bus->queue_head;
+    for (int i = 1; i < bus->queue_count; i++) {
+        idx = (idx + 1) % MAX_BUS_QUEUE;
+        if (CANBus_Arbitrate(&bus->queue[idx], &bus->queue[winner])) {
+            winner = idx;
+        }
+    }
+    *frame = bus->queue[winner];
+    
+    // Close the gap towards the head
+    while (winner != bus->queue_head) {
+        int prev = (winner + MAX_BUS_QUEUE - 1) % MAX_BUS_QUEUE;
+        bus->queue[winner] = bus->queue[prev];
+        winner = prev;
+    }
+    bus->queue_head = (bus->queue_head + 1) % MAX_BUS_QUEUE;
+    bus->queue_count--;
+    
+    return true;
+}
+
+// Put a frame that failed on the wire back at the head of the queue.
+// CAN controllers retry automatically, so this is not counted as a new frame.
+bool CANBus_Retransmit(CANBus* bus, const CANFrame* frame) {
+    if (bus->queue_count >= MAX_BUS_QUEUE) {
+        bus->stats.dropped_frames++;
+        return false;
+    }
+    
+    bus->queue_head = (bus->queue_head + MAX_BUS_QUEUE - 1) % MAX_BUS_QUEUE;
+    bus->queue[bus->queue_head] = *frame;
+    bus->queue_count++;
+    
+    return true;
+}
+
+void CANBus_Deliver(CANBus* bus, const CANFrame* frame) {
+    for (int i = 0; i < bus->monitor_count; i++) {
+        bus->monitors[i].fn(bus->monitors[i].ctx, frame);
+    }
+}
+
+bool CANBus_AttachMonitor(CANBus* bus, CANBusMonitor fn, void* ctx) {
+    if (bus->monitor_count >= MAX_SUBSCRIBERS) {
+        if (bus->verbose) printf("[BUS] Error: Too many monitors\n");
+        return false;
+    }
+    bus->monitors[bus->monitor_count].fn = fn;
+    bus->monitors[bus->monitor_count].ctx = ctx;
+    bus->monitor_count++;
     return true;
 }
 
@@ -0,0 +1,138 @@
+#include "can_error.h"
+#include <string.h>
+#include <math.h>
+
+static void update_state(CANErrorCounters* err) {
+    if (err->state == CAN_BUS_OFF) return;  // Left only through recovery
+
+    if (err->tec > CAN_BUS_OFF_LIMIT) {
+        err->state = CAN_BUS_OFF;
+        err->recovery_count = 0;
+        err->bus_off_events++;
+    } else if (err->tec > CAN_ERROR_PASSIVE_LIMIT || err->rec > CAN_ERROR_PASSIVE_LIMIT) {
+        err->state = CAN_ERROR_PASSIVE;
+    } else {
+        err->state = CAN_ERROR_ACTIVE;
+    }
+}
+
+void CANERR_Init(CANErrorCounters* err) {
+    memset(err, 0, sizeof(CANErrorCounters));
+    err->state = CAN_ERROR_ACTIVE;
+}
+
+void CANERR_OnTxSuccess(CANErrorCounters* err) {
+    if (err->tec > 0) {
+        err->tec--;
+        update_state(err);
+    }
+}
+
+void CANERR_OnTxError(CANErrorCounters* err, FaultType fault) {
+    if (err->state == CAN_BUS_OFF) return;
+
+    // An error-passive transmitter that only misses the ACK keeps its TEC
+    // (ISO 11898-1, exception to rule 3)
+    if (fault == FAULT_ACK_ERROR && err->state == CAN_ERROR_PASSIVE) return;
+
+    err->tec += 8;
+    update_state(err);
+}
+
+void CANERR_OnRxSuccess(CANErrorCounters* err) {
+    if (err->rec == 0) return;
+
+    if (err->rec > CAN_ERROR_PASSIVE_LIMIT) {
+        err->rec = 120;  // Any value between 119 and 127
+    } else {
+        err->rec--;
+    }
+    update_state(err);
+}
+
+void CANERR_OnRxError(CANErrorCounters* err) {
+    if (err->state == CAN_BUS_OFF) return;
+
+    // REC saturates; it cannot drive a node bus-off on its own
+    if (err->rec <= CAN_BUS_OFF_LIMIT) {
+        err->rec++;
+    }
+    update_state(err);
+}
+
+void CANERR_OnRecessiveSequence(CANErrorCounters* err, uint32_t count) {
+    if (err->state != CAN_BUS_OFF) return;
+
+    uint32_t total = err->recovery_count + count;
+    if (total >= CAN_BUS_OFF_RECOVERY) {
+        err->tec = 0;
+        err->rec = 0;
+        err->recovery_count = 0;
+        err->state = CAN_ERROR_ACTIVE;
+    } else {
+        err->recovery_count = (uint16_t)total;
+    }
+}
+
+bool CANERR_CanTransmit(const CANErrorCounters* err) {
+    return err->state != CAN_BUS_OFF;
+}
+
+const char* CANERR_StateName(CANErrorState state) {
+    switch (state) {
+        case CAN_ERROR_ACTIVE:  return "ERROR-ACTIVE";
+        case CAN_ERROR_PASSIVE: return "ERROR-PASSIVE";
+        case CAN_BUS_OFF:       return "BUS-OFF";
+        default:                return "UNKNOWN";
+    }
+}
+
+static uint64_t next_random(FaultInjector* inj) {
+    // xorshift64*
+    uint64_t x = inj->rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    inj->rng = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static uint32_t probability_threshold(double p) {
+    if (p <= 0.0) return 0;
+    if (p >= 1.0) return UINT32_MAX;
+    return (uint32_t)(p * 4294967296.0);
+}
+
+void FAULT_Init(FaultInjector* inj, double bit_error_rate, double ack_drop_rate, uint64_t seed) {
+    memset(inj, 0, sizeof(FaultInjector));
+    inj->bit_error_rate = bit_error_rate;
+    inj->ack_drop_rate = ack_drop_rate;
+    inj->rng = seed ? seed : 0xD1B54A32D192ED03ULL;
+
+    // P(at least one corrupted bit) for each frame length
+    for (int dlc = 0; dlc <= CAN_MAX_DATA_LEN; dlc++) {
+        double bits = CAN_FRAME_BITS(dlc);
+        inj->bit_threshold[dlc] = probability_threshold(1.0 - pow(1.0 - bit_error_rate, bits));
+    }
+    inj->ack_threshold = probability_threshold(ack_drop_rate);
+}
+
+FaultType FAULT_Inject(FaultInjector* inj, const CANFrame* frame, uint32_t frame_bits,
+                       uint32_t* error_bit) {
+    uint64_t r = next_random(inj);
+    uint32_t draw = (uint32_t)(r >> 32);
+
+    if (draw < inj->bit_threshold[frame->dlc]) {
+        // The low half picks where in the frame the error was detected
+        *error_bit = (uint32_t)(r & 0xFFFFFFFFu) % frame_bits;
+        inj->bit_errors++;
+        return FAULT_BIT_ERROR;
+    }
+    // Independent draw for the ACK slot
+    if (inj->ack_threshold && (uint32_t)r < inj->ack_threshold) {
+        *error_bit = frame_bits - 12;  // ACK slot
+        inj->ack_errors++;
+        return FAULT_ACK_ERROR;
+    }
+    return FAULT_NONE;
+}
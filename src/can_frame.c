@@ -1,18 +1,18 @@
 #include "can_frame.h"
+#include "sim_env.h"
 #include <stdio.h>
 #include <string.h>
-#include <time.h>
 
 void CAN_InitFrame(CANFrame* frame) {
     memset(frame, 0, sizeof(CANFrame));
-    frame->timestamp = (uint32_t)time(NULL);
+    frame->timestamp = SIM_GetTimeMs();
 }
 
 void CAN_SetData(CANFrame* frame, uint16_t id, const uint8_t* data, uint8_t len) {
     frame->id = id & 0x7FF;  // Mask to 11 bits
     frame->dlc = (len > CAN_MAX_DATA_LEN) ? CAN_MAX_DATA_LEN : len;
     memcpy(frame->data, data, frame->dlc);
-    frame->timestamp = (uint32_t)(time(NULL) * 1000);
+    frame->timestamp = SIM_GetTimeMs();
     frame->rtr = false;
     frame->error = false;
 }
@@ -0,0 +1,278 @@
+#include "checkpoint.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static uint32_t checksum(const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool validate_header(const CheckpointHeader* hdr, size_t file_size, const char* filename) {
+    if (file_size < sizeof(CheckpointHeader) ||
+        memcmp(hdr->magic, CHECKPOINT_MAGIC, sizeof(hdr->magic)) != 0) {
+        printf("[CKPT] Error: %s is not a checkpoint image\n", filename);
+        return false;
+    }
+    if (hdr->version != CHECKPOINT_VERSION ||
+        hdr->header_size != sizeof(CheckpointHeader) ||
+        hdr->payload_size != sizeof(SimSnapshot)) {
+        printf("[CKPT] Error: %s has incompatible version %u (expected %u)\n",
+               filename, hdr->version, CHECKPOINT_VERSION);
+        return false;
+    }
+    if (file_size < hdr->header_size + hdr->payload_size) {
+        printf("[CKPT] Error: %s is truncated\n", filename);
+        return false;
+    }
+    const uint8_t* payload = (const uint8_t*)hdr + hdr->header_size;
+    if (checksum(payload, hdr->payload_size) != hdr->checksum) {
+        printf("[CKPT] Error: %s failed checksum\n", filename);
+        return false;
+    }
+    return true;
+}
+
+bool Checkpoint_Save(const char* filename, const SimSnapshot* snap) {
+    CheckpointHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, CHECKPOINT_MAGIC, sizeof(hdr.magic));
+    hdr.version = CHECKPOINT_VERSION;
+    hdr.header_size = sizeof(CheckpointHeader);
+    hdr.payload_size = sizeof(SimSnapshot);
+    hdr.checksum = checksum(snap, sizeof(SimSnapshot));
+
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        printf("[CKPT] Error: Cannot open %s for writing\n", filename);
+        return false;
+    }
+    bool ok = fwrite(&hdr, sizeof(hdr), 1, file) == 1 &&
+              fwrite(snap, sizeof(SimSnapshot), 1, file) == 1;
+    if (fclose(file) != 0) ok = false;
+
+    if (!ok) {
+        printf("[CKPT] Error: Failed writing %s\n", filename);
+        return false;
+    }
+    printf("[CKPT] Saved cycle %u to %s (%u bytes)\n",
+           snap->cycle, filename, (unsigned)(sizeof(hdr) + sizeof(SimSnapshot)));
+    return true;
+}
+
+// The checksum only proves the image is intact, not that it came from a
+// sane run: check every index and count before it is copied into live state
+static bool validate_snapshot(const SimSnapshot* snap, int ecu_count) {
+    if (snap->ecu_count < 0 || snap->ecu_count > CHECKPOINT_MAX_ECUS) {
+        printf("[CKPT] Error: Checkpoint has an invalid ECU count (%d)\n", snap->ecu_count);
+        return false;
+    }
+    if (snap->ecu_count != ecu_count) {
+        printf("[CKPT] Error: Checkpoint has %d ECUs, simulation has %d\n",
+               snap->ecu_count, ecu_count);
+        return false;
+    }
+
+    const CANBus* bus = &snap->bus;
+    if (bus->queue_head < 0 || bus->queue_head >= MAX_BUS_QUEUE ||
+        bus->queue_tail < 0 || bus->queue_tail >= MAX_BUS_QUEUE ||
+        bus->queue_count < 0 || bus->queue_count > MAX_BUS_QUEUE ||
+        (bus->queue_head + bus->queue_count) % MAX_BUS_QUEUE != bus->queue_tail) {
+        printf("[CKPT] Error: Checkpoint has an inconsistent bus queue\n");
+        return false;
+    }
+    for (int i = 0; i < bus->queue_count; i++) {
+        if (!CAN_ValidateFrame(&bus->queue[(bus->queue_head + i) % MAX_BUS_QUEUE])) {
+            printf("[CKPT] Error: Checkpoint has an invalid queued frame\n");
+            return false;
+        }
+    }
+
+    for (int i = 0; i < snap->ecu_count; i++) {
+        const ECUNode* ecu = &snap->ecus[i];
+        const CANErrorCounters* err = &ecu->err;
+        if (memchr(ecu->name, '\0', sizeof(ecu->name)) == NULL ||
+            (err->state != CAN_ERROR_ACTIVE && err->state != CAN_ERROR_PASSIVE &&
+             err->state != CAN_BUS_OFF) ||
+            err->recovery_count > CAN_BUS_OFF_RECOVERY) {
+            printf("[CKPT] Error: Checkpoint has an invalid state for ECU %d\n", i);
+            return false;
+        }
+    }
+
+    if (snap->dtc.count < 0 || snap->dtc.count > MAX_DTC_ENTRIES) {
+        printf("[CKPT] Error: Checkpoint has an invalid DTC count (%d)\n", snap->dtc.count);
+        return false;
+    }
+    for (int i = 0; i < snap->dtc.count; i++) {
+        const DTCEntry* entry = &snap->dtc.entries[i];
+        if (memchr(entry->description, '\0', sizeof(entry->description)) == NULL) {
+            printf("[CKPT] Error: Checkpoint has an invalid DTC entry\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifndef _WIN32
+
+// Mapped length per open image: the file may be longer than the header says
+#define CHECKPOINT_MAX_MAPS 4
+
+static struct {
+    const void* base;
+    size_t size;
+} mappings[CHECKPOINT_MAX_MAPS];
+
+// Read-only private mapping: the image stays in the page cache and is
+// shared by every run forked from the same checkpoint.
+const SimSnapshot* Checkpoint_Map(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        printf("[CKPT] Error: Cannot open %s\n", filename);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(CheckpointHeader)) {
+        printf("[CKPT] Error: %s is not a checkpoint image\n", filename);
+        close(fd);
+        return NULL;
+    }
+    void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        printf("[CKPT] Error: Cannot map %s\n", filename);
+        return NULL;
+    }
+    const CheckpointHeader* hdr = (const CheckpointHeader*)base;
+    if (!validate_header(hdr, (size_t)st.st_size, filename)) {
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+    for (int i = 0; i < CHECKPOINT_MAX_MAPS; i++) {
+        if (!mappings[i].base) {
+            mappings[i].base = base;
+            mappings[i].size = (size_t)st.st_size;
+            return (const SimSnapshot*)((const uint8_t*)base + hdr->header_size);
+        }
+    }
+    printf("[CKPT] Error: Too many checkpoint images mapped\n");
+    munmap(base, (size_t)st.st_size);
+    return NULL;
+}
+
+void Checkpoint_Unmap(const SimSnapshot* snap) {
+    if (!snap) return;
+    const void* base = (const uint8_t*)snap - sizeof(CheckpointHeader);
+    for (int i = 0; i < CHECKPOINT_MAX_MAPS; i++) {
+        if (mappings[i].base == base) {
+            munmap((void*)base, mappings[i].size);
+            mappings[i].base = NULL;
+            return;
+        }
+    }
+}
+
+#else
+
+// No mmap on Windows builds: fall back to reading the image into memory
+const SimSnapshot* Checkpoint_Map(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        printf("[CKPT] Error: Cannot open %s\n", filename);
+        return NULL;
+    }
+    size_t size = sizeof(CheckpointHeader) + sizeof(SimSnapshot);
+    uint8_t* base = (uint8_t*)malloc(size);
+    size_t got = base ? fread(base, 1, size, file) : 0;
+    fclose(file);
+    if (!base || !validate_header((const CheckpointHeader*)base, got, filename)) {
+        free(base);
+        return NULL;
+    }
+    return (const SimSnapshot*)(base + sizeof(CheckpointHeader));
+}
+
+void Checkpoint_Unmap(const SimSnapshot* snap) {
+    if (!snap) return;
+    free((uint8_t*)snap - sizeof(CheckpointHeader));
+}
+
+#endif
+
+void Checkpoint_Capture(SimSnapshot* snap, const CANBus* bus, ECUNode* const ecus[],
+                        int ecu_count, const DTCManager* dtc, const IDSDetector* ids,
+                        uint32_t cycle) {
+    memset(snap, 0, sizeof(SimSnapshot));
+    SIM_GetState(&snap->env);
+    snap->cycle = cycle;
+    snap->ecu_count = (ecu_count > CHECKPOINT_MAX_ECUS) ? CHECKPOINT_MAX_ECUS : ecu_count;
+    snap->bus = *bus;
+    // Monitors and the fault injector are process-local pointers, never
+    // part of the image
+    memset(snap->bus.monitors, 0, sizeof(snap->bus.monitors));
+    snap->bus.monitor_count = 0;
+    snap->bus.faults = NULL;
+    for (int i = 0; i < snap->ecu_count; i++) {
+        snap->ecus[i] = *ecus[i];
+    }
+    snap->dtc = *dtc;
+    // The injector's rates come from the command line; its stream does not
+    if (bus->faults) {
+        snap->fault_rng = bus->faults->rng;
+        snap->fault_bit_errors = bus->faults->bit_errors;
+        snap->fault_ack_errors = bus->faults->ack_errors;
+    }
+    if (ids) {
+        snap->ids_saved = true;
+        snap->ids = *ids;
+        snap->ids.dtc = NULL;
+    }
+}
+
+bool Checkpoint_Restore(const SimSnapshot* snap, CANBus* bus, ECUNode* ecus[],
+                        int ecu_count, DTCManager* dtc, IDSDetector* ids, uint32_t* cycle) {
+    if (!validate_snapshot(snap, ecu_count)) {
+        return false;
+    }
+    SIM_SetState(&snap->env);
+    CANBus live = *bus;
+    *bus = snap->bus;
+    memcpy(bus->monitors, live.monitors, sizeof(bus->monitors));
+    bus->monitor_count = live.monitor_count;
+    bus->faults = live.faults;
+    // An image saved without faults keeps the live injector's seed
+    if (bus->faults && snap->fault_rng != 0) {
+        bus->faults->rng = snap->fault_rng;
+        bus->faults->bit_errors = snap->fault_bit_errors;
+        bus->faults->ack_errors = snap->fault_ack_errors;
+    }
+    for (int i = 0; i < ecu_count; i++) {
+        *ecus[i] = snap->ecus[i];
+    }
+    *dtc = snap->dtc;
+    // The detector keeps learning (or detecting) where the saved run left off
+    if (ids && snap->ids_saved) {
+        DTCManager* live_dtc = ids->dtc;
+        *ids = snap->ids;
+        ids->dtc = live_dtc;
+    } else if (ids) {
+        printf("[CKPT] Warning: Checkpoint has no detector state, IDS starts learning\n");
+    } else if (snap->ids_saved) {
+        printf("[CKPT] Warning: Detector state in checkpoint ignored (no --ids)\n");
+    }
+    *cycle = snap->cycle;
+    return true;
+}
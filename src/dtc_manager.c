@@ -1,7 +1,7 @@
 #include "dtc_manager.h"
+#include "sim_env.h"
 #include <stdio.h>
 #include <string.h>
-#include <time.h>
 
 void DTC_Init(DTCManager* mgr) {
     memset(mgr, 0, sizeof(DTCManager));
@@ -24,7 +24,7 @@ bool DTC_Add(DTCManager* mgr, DTCCode code, const char* description) {
     DTCEntry* entry = &mgr->entries[mgr->count];
     entry->code = code;
     strncpy(entry->description, description, sizeof(entry->description) - 1);
-    entry->timestamp = (uint32_t)time(NULL);
+    entry->timestamp = (uint32_t)(SIM_GetTimeMs64() / 1000);  // Unix seconds
     entry->active = true;
     mgr->count++;
     
@@ -1,8 +1,7 @@
 #include "ecu_node.h"
+#include "sim_env.h"
 #include <stdio.h>
 #include <string.h>
-#include <stdlib.h>
-#include <time.h>
 
 void ECU_Init(ECUNode* ecu, const char* name, ECUType type) {
     strncpy(ecu->name, name, ECU_NAME_LEN - 1);
@@ -11,17 +10,68 @@ void ECU_Init(ECUNode* ecu, const char* name, ECUType type) {
     ecu->frames_sent = 0;
     ecu->frames_received = 0;
     ecu->active = true;
+    CANERR_Init(&ecu->err);
 }
 
-void ECU_SendFrame(ECUNode* ecu, CANBus* bus, const CANFrame* frame) {
-    if (!ecu->active) return;
+// Failed attempts are retried at once, as a CAN controller would, until the
+// frame gets through or the node goes bus-off
+bool ECU_SendFrame(ECUNode* ecu, CANBus* bus, const CANFrame* frame) {
+    if (!ecu->active) return false;
+    
+    if (!CANERR_CanTransmit(&ecu->err)) {
+        printf("[%s] Bus-off, frame 0x%03X not sent\n", ecu->name, frame->id);
+        return false;
+    }
     
     printf("[%s] Sending: ", ecu->name);
     CAN_PrintFrame(frame);
     
-    if (CANBus_Transmit(bus, frame)) {
-        ecu->frames_sent++;
+    // Malformed frames never make it onto the wire (form error)
+    if (!CAN_ValidateFrame(frame)) {
+        CANBus_Transmit(bus, frame);
+        CANERR_OnTxError(&ecu->err, FAULT_BIT_ERROR);
+        printf("[%s] Form error on 0x%03X -> %s (TEC:%u)\n", ecu->name, frame->id,
+               CANERR_StateName(ecu->err.state), ecu->err.tec);
+        return false;
     }
+    
+    for (int attempt = 0; attempt < ECU_MAX_TX_ATTEMPTS; attempt++) {
+        FaultType fault = FAULT_NONE;
+        if (bus->faults) {
+            uint32_t error_bit;
+            fault = FAULT_Inject(bus->faults, frame, CAN_FRAME_BITS(frame->dlc), &error_bit);
+        }
+        
+        if (fault == FAULT_NONE) {
+            if (!CANBus_Transmit(bus, frame)) return false;
+            ecu->frames_sent++;
+            CANERR_OnTxSuccess(&ecu->err);
+            return true;
+        }
+        
+        // A corrupted bit is seen by every receiver as an error frame;
+        // a missing ACK only affects the transmitter
+        bus->stats.errors++;
+        if (fault == FAULT_BIT_ERROR) {
+            CANFrame error_frame = *frame;
+            error_frame.error = true;
+            CANBus_Transmit(bus, &error_frame);
+        }
+        CANERR_OnTxError(&ecu->err, fault);
+        printf("[%s] %s on 0x%03X -> %s (TEC:%u)\n", ecu->name,
+               (fault == FAULT_ACK_ERROR) ? "ACK error" : "Bit error", frame->id,
+               CANERR_StateName(ecu->err.state), ecu->err.tec);
+        
+        if (!CANERR_CanTransmit(&ecu->err)) {
+            printf("[%s] Bus-off, frame 0x%03X dropped\n", ecu->name, frame->id);
+            return false;
+        }
+    }
+    
+    // Only reachable with ACK errors while error-passive, which leave TEC alone
+    printf("[%s] Frame 0x%03X dropped after %d attempts\n", ecu->name, frame->id,
+           ECU_MAX_TX_ATTEMPTS);
+    return false;
 }
 
 bool ECU_ReceiveFrame(ECUNode* ecu, CANBus* bus, CANFrame* frame) {
@@ -41,6 +91,8 @@ void ECU_PrintStats(const ECUNode* ecu) {
     printf("  Frames Sent:     %u\n", ecu->frames_sent);
     printf("  Frames Received: %u\n", ecu->frames_received);
     printf("  Status:          %s\n", ecu->active ? "ACTIVE" : "INACTIVE");
+    printf("  Error State:     %s (TEC:%u REC:%u)\n",
+           CANERR_StateName(ecu->err.state), ecu->err.tec, ecu->err.rec);
 }
 
 // Simulated Engine Control ECU behavior
@@ -49,7 +101,7 @@ void ECU_EngineControl_Update(ECUNode* ecu, CANBus* bus) {
     CAN_InitFrame(&frame);
     
     // Simulate engine RPM (1000-6000 RPM)
-    uint16_t rpm = 1000 + (rand() % 5000);
+    uint16_t rpm = 1000 + (SIM_Rand() % 5000);
     uint8_t data[4] = {
         (rpm >> 8) & 0xFF,
         rpm & 0xFF,
@@ -61,7 +113,7 @@ void ECU_EngineControl_Update(ECUNode* ecu, CANBus* bus) {
     ECU_SendFrame(ecu, bus, &frame);
     
     // 5% chance of triggering engine fault
-    if (rand() % 100 < 5) {
+    if (SIM_Rand() % 100 < 5) {
         printf("  [%s] ⚠️  Engine misfire detected!\n", ecu->name);
     }
 }
@@ -72,7 +124,7 @@ void ECU_BrakeSystem_Update(ECUNode* ecu, CANBus* bus) {
     CAN_InitFrame(&frame);
     
     // Simulate brake status (random on/off)
-    uint8_t brake_status = (rand() % 10 < 3) ? 0x01 : 0x00;  // 30% chance pressed
+    uint8_t brake_status = (SIM_Rand() % 10 < 3) ? 0x01 : 0x00;  // 30% chance pressed
     
     CAN_SetData(&frame, CAN_ID_BRAKE_STATUS, &brake_status, 1);
     ECU_SendFrame(ecu, bus, &frame);
@@ -84,7 +136,7 @@ void ECU_BodyControl_Update(ECUNode* ecu, CANBus* bus) {
     CAN_InitFrame(&frame);
     
     // Simulate door status (all doors bitmap: bit0=driver, bit1=passenger, etc.)
-    uint8_t door_status = rand() % 16;  // Random door combination
+    uint8_t door_status = SIM_Rand() % 16;  // Random door combination
     
     CAN_SetData(&frame, CAN_ID_DOOR_STATUS, &door_status, 1);
     ECU_SendFrame(ecu, bus, &frame);
@@ -0,0 +1,205 @@
+#include "ids_detector.h"
+#include <stdio.h>
+#include <string.h>
+
+#define PROFILE_SEEN        0x01
+#define PROFILE_DLC_VARIES  0x02
+#define PROFILE_HAS_PERIOD  0x04
+#define IDS_CONST_GUARD     4       // Constant bytes: allowed distance from the learned value
+#define IDS_MIN_STEP        4       // Tracked bytes: smallest allowed step
+
+static const DTCCode verdict_dtc[IDS_VERDICT_COUNT] = {
+    DTC_NONE,
+    DTC_NETWORK_UNKNOWN_ID,
+    DTC_NETWORK_SPOOFED_FRAME,
+    DTC_NETWORK_SPOOFED_FRAME,
+    DTC_NETWORK_FLOODING
+};
+
+void IDS_Init(IDSDetector* ids, DTCManager* dtc, uint64_t learn_frames) {
+    memset(ids, 0, sizeof(IDSDetector));
+    ids->learning = true;
+    ids->learn_frames = learn_frames;
+    ids->dtc = dtc;
+}
+
+// Distance between two byte values, taking the shorter way round 0xFF/0x00
+static inline uint8_t byte_distance(uint8_t a, uint8_t b) {
+    int8_t d = (int8_t)(uint8_t)(a - b);
+    return (uint8_t)(d < 0 ? -d : d);
+}
+
+// Constant bytes keep their learned value with a small guard band.
+// Tracked bytes may step twice as far as they did while learning; random
+// bytes learn steps near 128 and are effectively unchecked.
+void IDS_EndLearning(IDSDetector* ids) {
+    ids->learning = false;
+    for (int i = 0; i < IDS_TABLE_SIZE; i++) {
+        IDSProfile* p = &ids->table[i];
+        p->flood_level = 0;
+        for (int b = 0; b < CAN_MAX_DATA_LEN; b++) {
+            int limit = IDS_CONST_GUARD;
+            if (p->tracked & (1u << b)) {
+                limit = p->limit[b] * 2;
+                if (limit < IDS_MIN_STEP) limit = IDS_MIN_STEP;
+                if (limit > 128) limit = 128;
+            }
+            p->limit[b] = (uint8_t)limit;
+        }
+    }
+}
+
+static void learn(IDSProfile* p, const CANFrame* frame) {
+    if (!(p->flags & PROFILE_SEEN)) {
+        p->flags = PROFILE_SEEN;
+        p->dlc = frame->dlc;
+        memcpy(p->ref, frame->data, CAN_MAX_DATA_LEN);
+        p->last_ts = frame->timestamp;
+        return;
+    }
+
+    if (frame->dlc != p->dlc) p->flags |= PROFILE_DLC_VARIES;
+    for (int b = 0; b < frame->dlc; b++) {
+        uint8_t step = byte_distance(frame->data[b], p->ref[b]);
+        if (step > p->limit[b]) p->limit[b] = step;
+        if (step) p->tracked |= (uint8_t)(1u << b);
+        p->ref[b] = frame->data[b];
+    }
+
+    // Bursty IDs learn a zero period and are never flagged as flooding
+    uint32_t interval = frame->timestamp - p->last_ts;
+    if (!(p->flags & PROFILE_HAS_PERIOD) || interval < p->min_period) {
+        p->min_period = interval;
+        p->flags |= PROFILE_HAS_PERIOD;
+    }
+    p->prev_ts = p->last_ts;
+    p->last_ts = frame->timestamp;
+}
+
+static inline uint32_t ts_distance(uint32_t a, uint32_t b) {
+    int32_t d = (int32_t)(a - b);
+    return (uint32_t)(d < 0 ? -(int64_t)d : d);
+}
+
+// A frame under half a period after the last on-time frame is early, unless
+// it lands on the expected slot (prev_ts + min_period) and nearer to it than
+// the last on-time frame did. Then an injected frame took the slot first and
+// the genuine frame takes it back, so a flood does not shift the schedule.
+static bool is_early(IDSProfile* p, uint32_t ts) {
+    if (!(p->flags & PROFILE_HAS_PERIOD) || ts - p->last_ts >= p->min_period / 2) {
+        p->prev_ts = p->last_ts;
+        p->last_ts = ts;
+        return false;
+    }
+
+    uint32_t due = p->prev_ts + p->min_period;
+    uint32_t offset = ts_distance(ts, due);
+    if (offset <= p->min_period / 8 && offset < ts_distance(p->last_ts, due)) {
+        p->last_ts = ts;
+        return false;
+    }
+    return true;
+}
+
+static IDSVerdict check(IDSProfile* p, const CANFrame* frame) {
+    if (!(p->flags & PROFILE_SEEN)) {
+        return IDS_UNKNOWN_ID;
+    }
+
+    bool early = is_early(p, frame->timestamp);
+
+    if (frame->dlc != p->dlc && !(p->flags & PROFILE_DLC_VARIES)) {
+        return IDS_DLC_MISMATCH;
+    }
+
+    uint8_t out_of_range = 0;
+    for (int b = 0; b < frame->dlc; b++) {
+        out_of_range |= (uint8_t)(byte_distance(frame->data[b], p->ref[b]) > p->limit[b]);
+    }
+    if (out_of_range) {
+        return IDS_PAYLOAD_RANGE;
+    }
+    for (int b = 0; b < frame->dlc; b++) {
+        if (p->tracked & (1u << b)) p->ref[b] = frame->data[b];
+    }
+
+    // Leaky bucket: early frames fill it, on-time frames drain it
+    if (early) {
+        p->flood_level += 2;
+        if (p->flood_level >= IDS_FLOOD_THRESHOLD) {
+            p->flood_level = IDS_FLOOD_THRESHOLD;
+            return IDS_FLOOD;
+        }
+    } else if (p->flood_level > 0) {
+        p->flood_level--;
+    }
+    return IDS_OK;
+}
+
+static void raise_dtc(IDSDetector* ids, IDSVerdict verdict, const CANFrame* frame) {
+    ids->dtc_raised |= 1u << verdict;
+    if (!ids->dtc) return;
+
+    char description[64];
+    snprintf(description, sizeof(description), "IDS: %s (ID 0x%03X)",
+             IDS_VerdictName(verdict), frame->id);
+    DTC_Add(ids->dtc, verdict_dtc[verdict], description);
+}
+
+IDSVerdict IDS_Inspect(IDSDetector* ids, const CANFrame* frame) {
+    IDSProfile* p = &ids->table[frame->id & (IDS_TABLE_SIZE - 1)];
+    ids->frames++;
+
+    if (ids->learning) {
+        learn(p, frame);
+        if (ids->learn_frames && ids->frames >= ids->learn_frames) {
+            IDS_EndLearning(ids);
+        }
+        return IDS_OK;
+    }
+
+    IDSVerdict verdict = check(p, frame);
+    if (verdict != IDS_OK) {
+        ids->alerts[verdict]++;
+        if (!(ids->dtc_raised & (1u << verdict))) {
+            raise_dtc(ids, verdict, frame);
+        }
+    }
+    return verdict;
+}
+
+// Error frames carry corrupted data and are not inspected
+void IDS_Monitor(void* ctx, const CANFrame* frame) {
+    if (frame->error) return;
+    IDS_Inspect((IDSDetector*)ctx, frame);
+}
+
+const char* IDS_VerdictName(IDSVerdict verdict) {
+    switch (verdict) {
+        case IDS_OK:            return "OK";
+        case IDS_UNKNOWN_ID:    return "Unknown ID";
+        case IDS_DLC_MISMATCH:  return "DLC mismatch";
+        case IDS_PAYLOAD_RANGE: return "Payload out of range";
+        case IDS_FLOOD:         return "Flooding";
+        default:                return "Unknown";
+    }
+}
+
+void IDS_PrintStats(const IDSDetector* ids) {
+    int profiles = 0;
+    for (int i = 0; i < IDS_TABLE_SIZE; i++) {
+        if (ids->table[i].flags & PROFILE_SEEN) profiles++;
+    }
+
+    printf("\n========================================\n");
+    printf("      INTRUSION DETECTION               \n");
+    printf("========================================\n");
+    printf("Mode:            %s\n", ids->learning ? "LEARNING" : "DETECTING");
+    printf("Known IDs:       %d\n", profiles);
+    printf("Frames:          %llu\n", (unsigned long long)ids->frames);
+    for (int v = IDS_UNKNOWN_ID; v < IDS_VERDICT_COUNT; v++) {
+        printf("%-22s %llu\n", IDS_VerdictName((IDSVerdict)v),
+               (unsigned long long)ids->alerts[v]);
+    }
+    printf("========================================\n");
+}
@@ -1,15 +1,83 @@
 #include "json_logger.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 #include <signal.h>
+#include <pthread.h>
 #include "can_bus.h"
 #include "ecu_node.h"
 #include "dtc_manager.h"
+#include "sim_env.h"
+#include "checkpoint.h"
+#include "rt_scheduler.h"
+#include "can_archive.h"
+#include "traffic_gen.h"
+#include "ids_detector.h"
+#include "shm_transport.h"
+
+#define DEFAULT_CYCLES 12
+#define CYCLE_PERIOD_MS 2000
+#define LOADTEST_MAX_POINTS 16
+#define RT_LOG_SIZE 4096            // Power of two; ~25 s of default traffic
+#define RT_LOG_POLL_NS 10000000L    // Writer thread wakeup when idle
+
+// Command line options
+typedef struct {
+    int cycles;
+    bool fast;                      // Skip the wall-clock sleep between cycles
+    bool seed_set;
+    uint32_t seed;
+    const char* checkpoint_save;
+    const char* checkpoint_load;
+    uint32_t realtime_s;            // Real-time paced mode duration, 0 = cycle mode
+    int rt_cpu;
+    int rt_fifo_priority;
+    const char* archive;            // Columnar archive written alongside the JSON log
+    uint32_t archive_bench;         // Frames for the archive benchmark, 0 = off
+    double loadtest_s;              // Simulated seconds per load point, 0 = off
+    uint32_t bitrate;
+    double load_targets[LOADTEST_MAX_POINTS];   // Utilisation points, none = default sweep
+    int load_target_count;
+    const char* streams[TGEN_MAX_STREAMS];      // Stream specs, none = default network
+    int stream_count;
+    double bit_error_rate;          // Load test fault injection
+    double ack_drop_rate;
+    uint32_t ids_learn_frames;      // Attach the intrusion detector, 0 = off
+    uint32_t ids_bench;             // Frames for the detector benchmark, 0 = off
+    const char* shm_name;           // Shared-memory transport for external ECUs
+    bool shm_bridge;                // Only bridge external ECUs, no built-in traffic
+} SimOptions;
+
+// Frames sent during a real-time run. The release path only appends to
+// this single-producer ring; a writer thread drains it to the log files.
+typedef struct {
+    CANFrame frame;
+    const char* ecu_name;
+} RTLogEntry;
+
+typedef struct {
+    RTLogEntry entries[RT_LOG_SIZE];
+    uint32_t head;                  // Written by the release path only
+    uint32_t tail;                  // Written by the writer thread only
+    uint32_t stop;
+    uint64_t dropped;               // Writer fell a whole ring behind
+} RTLog;
+
+// Periodic message driven by the real-time scheduler
+typedef struct {
+    ECUNode* sender;
+    ECUNode* monitor;
+    CANBus* bus;
+    CANFrame (*create)(void);
+    RTLog* log;
+} RTMessage;
 
 // Global DTC manager
 DTCManager dtc_mgr;
+IDSDetector ids;
+SHMTransport shm;
 volatile sig_atomic_t keep_running = 1;
 
 void signal_handler(int sig) {
@@ -17,6 +85,12 @@ void signal_handler(int sig) {
     keep_running = 0;
 }
 
+// Logging path: dashboard JSON plus the optional archive
+static void log_frame(const CANFrame* frame, const char* ecu_name) {
+    JSON_LogFrame(frame, ecu_name);
+    ARC_LogFrame(frame);
+}
+
 // Simulate arbitration when multiple ECUs try to send
 void simulate_arbitration(ECUNode* ecu1, ECUNode* ecu2, CANBus* bus, 
                           CANFrame* frame1, CANFrame* frame2) {
@@ -26,15 +100,17 @@ void simulate_arbitration(ECUNode* ecu1, ECUNode* ecu2, CANBus* bus,
     
     if (CANBus_Arbitrate(frame1, frame2)) {
         printf("   --> [%s] WINS (lower ID = higher priority)\n", ecu1->name);
-        ECU_SendFrame(ecu1, bus, frame1);
-        JSON_LogFrame(frame1, ecu1->name);
+        if (ECU_SendFrame(ecu1, bus, frame1)) {
+            log_frame(frame1, ecu1->name);
+        }
         bus->stats.collisions++;
         // frame2 will retry in next cycle
         printf("   --> [%s] backs off, will retry\n", ecu2->name);
     } else {
         printf("   --> [%s] WINS (lower ID = higher priority)\n", ecu2->name);
-        ECU_SendFrame(ecu2, bus, frame2);
-        JSON_LogFrame(frame2, ecu2->name);
+        if (ECU_SendFrame(ecu2, bus, frame2)) {
+            log_frame(frame2, ecu2->name);
+        }
         bus->stats.collisions++;
         printf("   --> [%s] backs off, will retry\n", ecu1->name);
     }
@@ -47,6 +123,14 @@ void process_messages(ECUNode* ecu, CANBus* bus) {
     while (CANBus_Receive(bus, &frame)) {
         ecu->frames_received++;
         
+        if (frame.error) {
+            CANERR_OnRxError(&ecu->err);
+            printf("  [%s] Error frame on ID=0x%03X -> %s (REC:%u)\n", ecu->name, frame.id,
+                   CANERR_StateName(ecu->err.state), ecu->err.rec);
+            continue;
+        }
+        CANERR_OnRxSuccess(&ecu->err);
+        
         switch (ecu->type) {
             case ECU_INFOTAINMENT:
                 printf("  [%s] Monitoring: ID=0x%03X ", ecu->name, frame.id);
@@ -104,7 +188,7 @@ void process_messages(ECUNode* ecu, CANBus* bus) {
 CANFrame create_engine_frame(void) {
     CANFrame frame;
     CAN_InitFrame(&frame);
-    uint16_t rpm = 1000 + (rand() % 5000);
+    uint16_t rpm = 1000 + (SIM_Rand() % 5000);
     uint8_t data[4] = {(rpm >> 8) & 0xFF, rpm & 0xFF, 0x00, 0x00};
     CAN_SetData(&frame, CAN_ID_ENGINE_RPM, data, 4);
     return frame;
@@ -114,7 +198,7 @@ CANFrame create_engine_frame(void) {
 CANFrame create_brake_frame(void) {
     CANFrame frame;
     CAN_InitFrame(&frame);
-    uint8_t brake_status = (rand() % 10 < 3) ? 0x01 : 0x00;
+    uint8_t brake_status = (SIM_Rand() % 10 < 3) ? 0x01 : 0x00;
     CAN_SetData(&frame, CAN_ID_BRAKE_STATUS, &brake_status, 1);
     return frame;
 }
@@ -123,17 +207,555 @@ CANFrame create_brake_frame(void) {
 CANFrame create_body_frame(void) {
     CANFrame frame;
     CAN_InitFrame(&frame);
-    uint8_t door_status = rand() % 16;
+    uint8_t door_status = SIM_Rand() % 16;
     CAN_SetData(&frame, CAN_ID_DOOR_STATUS, &door_status, 1);
     return frame;
 }
 
-int main(void) {
-    srand((unsigned int)time(NULL));
+static void rt_log_push(RTLog* log, const CANFrame* frame, const char* ecu_name) {
+    uint32_t head = log->head;
+    if (head - __atomic_load_n(&log->tail, __ATOMIC_ACQUIRE) >= RT_LOG_SIZE) {
+        log->dropped++;
+        return;
+    }
+    RTLogEntry* entry = &log->entries[head & (RT_LOG_SIZE - 1)];
+    entry->frame = *frame;
+    entry->ecu_name = ecu_name;
+    __atomic_store_n(&log->head, head + 1, __ATOMIC_RELEASE);
+}
+
+// Writer thread: the only user of the JSON log and archive during the run
+static void* rt_log_writer(void* arg) {
+    RTLog* log = (RTLog*)arg;
+    uint32_t tail = log->tail;
+    for (;;) {
+        // Stop is read first, so the head read after it covers every frame
+        bool stopping = __atomic_load_n(&log->stop, __ATOMIC_ACQUIRE) != 0;
+        uint32_t head = __atomic_load_n(&log->head, __ATOMIC_ACQUIRE);
+        if (tail == head) {
+            if (stopping) break;
+            struct timespec idle = {0, RT_LOG_POLL_NS};
+            nanosleep(&idle, NULL);
+            continue;
+        }
+        for (; tail != head; tail++) {
+            const RTLogEntry* entry = &log->entries[tail & (RT_LOG_SIZE - 1)];
+            log_frame(&entry->frame, entry->ecu_name);
+            __atomic_store_n(&log->tail, tail + 1, __ATOMIC_RELEASE);
+        }
+    }
+    return NULL;
+}
+
+// Real-time release: transmit the next frame and let the monitor drain the bus.
+// Nothing is printed or written here so I/O cannot disturb the timing; sent
+// frames go to the log ring instead.
+static void rt_release(void* ctx, uint64_t release_ns) {
+    RTMessage* msg = (RTMessage*)ctx;
+    CANFrame frame = msg->create();
+    frame.timestamp = (uint32_t)(release_ns / 1000000ULL);
+
+    if (CANBus_Transmit(msg->bus, &frame)) {
+        msg->sender->frames_sent++;
+        rt_log_push(msg->log, &frame, msg->sender->name);
+    }
+    CANFrame rx;
+    while (CANBus_Receive(msg->bus, &rx)) {
+        msg->monitor->frames_received++;
+    }
+}
+
+static void run_realtime(const SimOptions* opts, CANBus* bus, ECUNode* engine,
+                         ECUNode* brake, ECUNode* body, ECUNode* monitor) {
+    static RTLog log;
+    memset(&log, 0, sizeof(log));
+    RTMessage messages[] = {
+        {engine, monitor, bus, create_engine_frame, &log},
+        {brake,  monitor, bus, create_brake_frame, &log},
+        {body,   monitor, bus, create_body_frame, &log},
+    };
+
+    RTScheduler sched;
+    RT_Init(&sched, opts->rt_cpu, opts->rt_fifo_priority);
+    RT_AddTask(&sched, "EngineRPM",  CAN_ID_ENGINE_RPM,   10000, rt_release, &messages[0]);
+    RT_AddTask(&sched, "BrakeStat",  CAN_ID_BRAKE_STATUS, 20000, rt_release, &messages[1]);
+    RT_AddTask(&sched, "DoorStatus", CAN_ID_DOOR_STATUS, 100000, rt_release, &messages[2]);
+
+    // Started before RT_Run, so it keeps the normal policy and CPU set
+    // instead of inheriting the pinned SCHED_FIFO settings
+    pthread_t writer;
+    if (pthread_create(&writer, NULL, rt_log_writer, &log) != 0) {
+        printf("[RT] Error: Cannot start the log writer thread\n");
+        return;
+    }
+
+    bool ran = RT_Run(&sched, opts->realtime_s * 1000, &keep_running);
+
+    __atomic_store_n(&log.stop, 1, __ATOMIC_RELEASE);
+    pthread_join(writer, NULL);
+    if (ran) {
+        RT_PrintStats(&sched);
+    }
+    if (log.dropped > 0) {
+        printf("[RT] Warning: %llu frames not logged (writer fell behind)\n",
+               (unsigned long long)log.dropped);
+    }
+}
+
+// Order-dependent hash of one frame, used to verify archive round trips
+static uint32_t frame_hash(uint32_t hash, const CANFrame* frame) {
+    hash = (hash ^ frame->id) * 16777619u;
+    hash = (hash ^ frame->timestamp) * 16777619u;
+    hash = (hash ^ frame->dlc) * 16777619u;
+    for (int i = 0; i < frame->dlc; i++) {
+        hash = (hash ^ frame->data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Encode/decode simulated traffic (10/20/100 ms message periods) and report
+// compression ratio and throughput
+static void run_archive_bench(uint32_t frame_count) {
+    const char* filename = "archive_bench.cnarc";
+    CANFrame* frames = (CANFrame*)malloc(sizeof(CANFrame) * frame_count);
+    ARCWriter* writer = (ARCWriter*)malloc(sizeof(ARCWriter));
+    ARCReader* reader = (ARCReader*)malloc(sizeof(ARCReader));
+    uint32_t expected = 2166136261u;
+    uint32_t actual = 2166136261u;
+    if (!frames || !writer || !reader) {
+        printf("[ARC] Error: Out of memory\n");
+        goto cleanup;
+    }
+
+    for (uint32_t n = 0, tick = 0; n < frame_count; tick++) {
+        frames[n++] = create_engine_frame();
+        if (tick % 2 == 0 && n < frame_count) frames[n++] = create_brake_frame();
+        if (tick % 10 == 0 && n < frame_count) frames[n++] = create_body_frame();
+        SIM_AdvanceTime(10);
+    }
+    for (uint32_t n = 0; n < frame_count; n++) {
+        expected = frame_hash(expected, &frames[n]);
+    }
+
+    clock_t start = clock();
+    if (!ARC_OpenWriter(writer, filename)) goto cleanup;
+    for (uint32_t n = 0; n < frame_count; n++) {
+        ARC_WriteFrame(writer, &frames[n]);
+    }
+    ARC_CloseWriter(writer);
+    double encode_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    uint32_t decoded = 0;
+    CANFrame frame;
+    if (!ARC_OpenReader(reader, filename)) goto cleanup;
+    while (ARC_ReadFrame(reader, &frame)) {
+        actual = frame_hash(actual, &frame);
+        decoded++;
+    }
+    ARC_CloseReader(reader);
+    double decode_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    // The decoder must return the capture's frame stream in its original order
+    bool match = (decoded == frame_count) && (expected == actual);
+
+    printf("\n========================================\n");
+    printf("      ARCHIVE BENCHMARK                 \n");
+    printf("========================================\n");
+    printf("Frames:          %u\n", frame_count);
+    printf("Raw bytes:       %llu\n", (unsigned long long)writer->raw_bytes);
+    printf("Archive bytes:   %llu\n", (unsigned long long)writer->encoded_bytes);
+    printf("Ratio:           %.2fx\n",
+           (double)writer->raw_bytes / (double)writer->encoded_bytes);
+    printf("Bytes/frame:     %.2f\n", (double)writer->encoded_bytes / frame_count);
+    printf("Encode:          %.1f Mframes/s\n",
+           encode_s > 0 ? frame_count / encode_s / 1e6 : 0.0);
+    printf("Decode:          %.1f Mframes/s\n",
+           decode_s > 0 ? frame_count / decode_s / 1e6 : 0.0);
+    printf("Round trip:      %s\n", match ? "OK" : "MISMATCH");
+    printf("========================================\n");
+    remove(filename);
+
+cleanup:
+    free(frames);
+    free(writer);
+    free(reader);
+}
+
+// Generator throughput, then a utilisation sweep up to 150% of the bus
+static bool run_loadtest(const SimOptions* opts) {
+    static const char* node_names[] = {"Engine-ECU", "Brake-ECU", "Body-ECU", "Infotainment-ECU"};
+    const int node_count = (int)(sizeof(node_names) / sizeof(node_names[0]));
+    static const double default_targets[] = {0.30, 0.50, 0.70, 0.80, 0.90, 1.00, 1.10, 1.25, 1.50};
+    const double* targets = default_targets;
+    int target_count = (int)(sizeof(default_targets) / sizeof(default_targets[0]));
+    const uint32_t bench_frames = 20000000;
+
+    if (opts->load_target_count > 0) {
+        targets = opts->load_targets;
+        target_count = opts->load_target_count;
+    }
+
+    TrafficGen gen;
+    TGEN_Init(&gen, opts->bitrate, SIM_Rand() | 1ULL);
+    if (opts->stream_count > 0) {
+        for (int i = 0; i < opts->stream_count; i++) {
+            if (!TGEN_AddStreamSpec(&gen, opts->streams[i])) {
+                return false;
+            }
+        }
+    } else {
+        TGEN_AddDefaultStreams(&gen);
+    }
+    TGEN_Reset(&gen);
+
+    CANFrame frame;
+    uint64_t release_ns = 0;
+    uint32_t checksum = 0;
+    clock_t start = clock();
+    for (uint32_t n = 0; n < bench_frames; n++) {
+        TGEN_Next(&gen, &frame, &release_ns);
+        checksum += frame.data[0];
+    }
+    double gen_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("\n========================================\n");
+    printf("      BUS LOAD TEST                     \n");
+    printf("========================================\n");
+    printf("Bitrate:         %u bit/s\n", gen.bitrate);
+    printf("Streams:         %d\n", gen.stream_count);
+    printf("Generator:       %.1f Mframes/s (checksum %u)\n",
+           gen_s > 0 ? bench_frames / gen_s / 1e6 : 0.0, checksum);
+    printf("Bit error rate:  %g\n", opts->bit_error_rate);
+    printf("ACK drop rate:   %g\n", opts->ack_drop_rate);
+    printf("Sim time/point:  %.1f s\n\n", opts->loadtest_s);
+
+    FaultInjector faults;
+    FAULT_Init(&faults, opts->bit_error_rate, opts->ack_drop_rate, SIM_Rand() | 1ULL);
+    bool inject = (opts->bit_error_rate > 0.0 || opts->ack_drop_rate > 0.0);
+
+    ECUNode nodes[4];
+    uint64_t simulated = 0;
+    start = clock();
+
+    TGEN_PrintReportHeader();
+    for (int i = 0; i < target_count; i++) {
+        CANBus bus;
+        CANBus_Init(&bus);
+        for (int n = 0; n < node_count; n++) {
+            ECU_Init(&nodes[n], node_names[n], (ECUType)n);
+        }
+        TGenReport report;
+        TGEN_ScaleToUtilisation(&gen, targets[i]);
+        TGEN_RunLoadTest(&gen, &bus, inject ? &faults : NULL, nodes, node_count,
+                         (uint64_t)(opts->loadtest_s * 1e9), &report);
+        TGEN_PrintReport(&report);
+        simulated += report.generated;
+    }
+    double sim_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("\nSimulation:      %.1f Mframes/s\n", sim_s > 0 ? simulated / sim_s / 1e6 : 0.0);
+    printf("Node error state at %.0f%% load:\n", targets[target_count - 1] * 100.0);
+    for (int n = 0; n < node_count; n++) {
+        printf("  %-18s %-14s TEC:%-3u REC:%-3u Bus-off events: %u\n",
+               nodes[n].name, CANERR_StateName(nodes[n].err.state),
+               nodes[n].err.tec, nodes[n].err.rec, nodes[n].err.bus_off_events);
+    }
+    printf("========================================\n");
+    return true;
+}
+
+// Learn on 60 s of clean generator traffic, then inspect frame_count frames
+// with one attack in every 1000 (unknown ID, spoofed payload, 8-frame flood).
+// Fails if any clean frame is flagged or any attack is missed.
+static bool run_ids_bench(uint32_t frame_count) {
+    enum { ATTACK_NONE, ATTACK_INJECT, ATTACK_SPOOF, ATTACK_FLOOD };
+    static const char* attack_names[] = {"Clean", "Injected ID", "Spoofed payload", "Flooding"};
+    const uint64_t learn_ns = 60ULL * 1000000000ULL;
+
+    CANFrame* frames = (CANFrame*)malloc(sizeof(CANFrame) * frame_count);
+    uint8_t* attack = (uint8_t*)malloc(frame_count);
+    if (!frames || !attack) {
+        printf("[IDS] Error: Out of memory\n");
+        free(frames);
+        free(attack);
+        return false;
+    }
+
+    DTCManager bench_dtc;
+    DTC_Init(&bench_dtc);
+    IDS_Init(&ids, &bench_dtc, 0);
+
+    TrafficGen gen;
+    TGEN_Init(&gen, TGEN_DEFAULT_BITRATE, SIM_Rand() | 1ULL);
+    TGEN_AddDefaultStreams(&gen);
+    TGEN_Reset(&gen);
+
+    CANFrame frame;
+    uint64_t release_ns = 0;
+    uint32_t learned = 0;
+    do {
+        TGEN_Next(&gen, &frame, &release_ns);
+        IDS_Inspect(&ids, &frame);
+        learned++;
+    } while (release_ns < learn_ns);
+    IDS_EndLearning(&ids);
+
+    CANFrame last_brake;
+    CAN_InitFrame(&last_brake);
+    for (uint32_t n = 0; n < frame_count; ) {
+        TGEN_Next(&gen, &frame, &release_ns);
+        if (n % 1000 != 999) {
+            if (frame.id == CAN_ID_BRAKE_STATUS) last_brake = frame;
+            attack[n] = ATTACK_NONE;
+            frames[n++] = frame;
+            continue;
+        }
+        switch ((n / 1000) % 3) {
+            case 0:
+                frame.id = 0x6A0;
+                attack[n] = ATTACK_INJECT;
+                frames[n++] = frame;
+                break;
+            case 1:
+                frame.id = CAN_ID_ENGINE_RPM;
+                frame.dlc = 8;
+                frame.data[7] ^= 0x5A;
+                attack[n] = ATTACK_SPOOF;
+                frames[n++] = frame;
+                break;
+            default:
+                // Replay of a genuine brake frame, far faster than its period.
+                // The replays follow the current bus instant, so they never
+                // share a timestamp with a genuine brake frame.
+                frame = last_brake;
+                frame.timestamp = (uint32_t)(release_ns / 1000) + 1;
+                for (int k = 0; k < 8 && n < frame_count; k++) {
+                    attack[n] = ATTACK_FLOOD;
+                    frames[n++] = frame;
+                }
+                break;
+        }
+    }
+
+    IDSVerdict* verdicts = (IDSVerdict*)malloc(sizeof(IDSVerdict) * frame_count);
+    if (!verdicts) {
+        printf("[IDS] Error: Out of memory\n");
+        free(frames);
+        free(attack);
+        return false;
+    }
+
+    clock_t start = clock();
+    for (uint32_t n = 0; n < frame_count; n++) {
+        verdicts[n] = IDS_Inspect(&ids, &frames[n]);
+    }
+    double inspect_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    // Per attack type: frames, frames flagged. Floods count once per burst.
+    uint64_t total[4] = {0}, flagged[4] = {0};
+    for (uint32_t n = 0; n < frame_count; n++) {
+        int a = attack[n];
+        if (a == ATTACK_FLOOD) {
+            bool hit = false;
+            uint32_t end = n;
+            while (end < frame_count && attack[end] == ATTACK_FLOOD) {
+                hit |= (verdicts[end] != IDS_OK);
+                end++;
+            }
+            total[a]++;
+            flagged[a] += hit;
+            n = end - 1;
+            continue;
+        }
+        total[a]++;
+        flagged[a] += (verdicts[n] != IDS_OK);
+    }
+
+    IDS_PrintStats(&ids);
+    printf("Learning frames: %u (60 s of bus time)\n", learned);
+    printf("Inspect cost:    %.1f ns/frame\n",
+           frame_count ? inspect_s * 1e9 / frame_count : 0.0);
+    bool pass = (flagged[ATTACK_NONE] == 0);
+    for (int a = ATTACK_NONE; a <= ATTACK_FLOOD; a++) {
+        printf("%-16s %llu/%llu flagged\n", attack_names[a],
+               (unsigned long long)flagged[a], (unsigned long long)total[a]);
+        if (a != ATTACK_NONE && flagged[a] != total[a]) pass = false;
+    }
+    printf("Result:          %s\n", pass ? "PASS" :
+           "FAIL (false positives or missed attacks)");
+    DTC_PrintAll(&bench_dtc);
+
+    free(frames);
+    free(attack);
+    free(verdicts);
+    return pass;
+}
+
+// Put frames from external (shared-memory) ECUs on the bus
+static int service_shm_clients(CANBus* bus) {
+    CANFrame frame;
+    int count = 0;
+    while (SHM_ServerPoll(&shm, &frame)) {
+        frame.timestamp = SIM_GetTimeMs();  // Bus time, not the client's clock
+        if (CANBus_Transmit(bus, &frame)) {
+            log_frame(&frame, "SHM-Client");
+            count++;
+        }
+    }
+    return count;
+}
+
+// Low-latency loop for external ECUs: wake on client frames, deliver
+// them immediately (the SHM monitor publishes each delivery back)
+static void run_shm_bridge(CANBus* bus, ECUNode* monitor) {
+    printf("[SHM] Bridging bus on %s, press Ctrl+C to stop\n", shm.name);
+    CANFrame frame, rx;
+    uint64_t bridged = 0;
+    while (keep_running) {
+        // Poll even after a timeout, so a stalled reservation gets reclaimed
+        SHM_ServerWait(&shm, 100);
+        while (SHM_ServerPoll(&shm, &frame)) {
+            frame.timestamp = SIM_GetTimeMs();
+            if (!CANBus_Transmit(bus, &frame)) continue;
+            log_frame(&frame, "SHM-Client");
+            while (CANBus_Receive(bus, &rx)) {
+                monitor->frames_received++;
+            }
+            bridged++;
+        }
+    }
+    printf("[SHM] Bridged %llu frames\n", (unsigned long long)bridged);
+    if (shm.tx_abandoned > 0) {
+        printf("[SHM] Reclaimed %llu abandoned TX reservations\n",
+               (unsigned long long)shm.tx_abandoned);
+    }
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  --cycles N              Number of cycles to run (default %d)\n", DEFAULT_CYCLES);
+    printf("  --fast                  Do not sleep between cycles\n");
+    printf("  --seed S                Seed the simulation RNG (reseeds after a restore)\n");
+    printf("  --checkpoint-save FILE  Write a checkpoint image after the last cycle\n");
+    printf("  --checkpoint-load FILE  Resume from a checkpoint image\n");
+    printf("  --realtime SECONDS      Paced mode with real message periods (Linux)\n");
+    printf("  --rt-cpu N              Pin the real-time loop to CPU N\n");
+    printf("  --rt-fifo PRIO          Use SCHED_FIFO with priority PRIO\n");
+    printf("  --archive FILE          Also log frames to a compressed columnar archive\n");
+    printf("  --archive-bench N       Benchmark the archive format on N simulated frames\n");
+    printf("  --loadtest SECONDS      Bus saturation sweep, SECONDS of bus time per point\n");
+    printf("  --bitrate BPS           Bus bitrate for the load test (default %d)\n",
+           TGEN_DEFAULT_BITRATE);
+    printf("  --load-target PCT       Load test point in %% utilisation, repeatable\n");
+    printf("                          (default sweep 30..150%%)\n");
+    printf("  --stream SPEC           Load test stream id:dlc:mode:rate:payload[:burst[:node]],\n");
+    printf("                          repeatable, replaces the default network; modes\n");
+    printf("                          periodic|bursty|poisson, payloads constant|counter|ramp|random\n");
+    printf("  --ber RATE              Probability of a corrupted bit (cycle mode and load test)\n");
+    printf("  --ack-drop RATE         Probability of a missing ACK per frame\n");
+    printf("  --ids N                 Intrusion detector: learn on N frames, then detect\n");
+    printf("  --ids-bench N           Benchmark the intrusion detector on N frames\n");
+    printf("  --shm NAME              Let external ECUs attach via shared memory /NAME\n");
+    printf("  --bridge                With --shm: only bridge external ECUs until Ctrl+C\n");
+}
+
+static bool parse_options(int argc, char* argv[], SimOptions* opts) {
+    memset(opts, 0, sizeof(SimOptions));
+    opts->cycles = DEFAULT_CYCLES;
+    opts->rt_cpu = -1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = (i + 1 < argc);
+
+        if (strcmp(arg, "--fast") == 0) {
+            opts->fast = true;
+        } else if (strcmp(arg, "--cycles") == 0 && has_value) {
+            opts->cycles = atoi(argv[++i]);
+        } else if (strcmp(arg, "--seed") == 0 && has_value) {
+            opts->seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+            opts->seed_set = true;
+        } else if (strcmp(arg, "--checkpoint-save") == 0 && has_value) {
+            opts->checkpoint_save = argv[++i];
+        } else if (strcmp(arg, "--checkpoint-load") == 0 && has_value) {
+            opts->checkpoint_load = argv[++i];
+        } else if (strcmp(arg, "--realtime") == 0 && has_value) {
+            opts->realtime_s = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--rt-cpu") == 0 && has_value) {
+            opts->rt_cpu = atoi(argv[++i]);
+        } else if (strcmp(arg, "--rt-fifo") == 0 && has_value) {
+            opts->rt_fifo_priority = atoi(argv[++i]);
+        } else if (strcmp(arg, "--archive") == 0 && has_value) {
+            opts->archive = argv[++i];
+        } else if (strcmp(arg, "--archive-bench") == 0 && has_value) {
+            opts->archive_bench = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--loadtest") == 0 && has_value) {
+            opts->loadtest_s = atof(argv[++i]);
+        } else if (strcmp(arg, "--bitrate") == 0 && has_value) {
+            opts->bitrate = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--load-target") == 0 && has_value) {
+            double pct = atof(argv[++i]);
+            if (pct <= 0.0 || opts->load_target_count >= LOADTEST_MAX_POINTS) {
+                printf("[TGEN] Error: Bad load target '%s' (max %d points)\n",
+                       argv[i], LOADTEST_MAX_POINTS);
+                return false;
+            }
+            opts->load_targets[opts->load_target_count++] = pct / 100.0;
+        } else if (strcmp(arg, "--stream") == 0 && has_value) {
+            if (opts->stream_count >= TGEN_MAX_STREAMS) {
+                printf("[TGEN] Error: At most %d streams\n", TGEN_MAX_STREAMS);
+                return false;
+            }
+            opts->streams[opts->stream_count++] = argv[++i];
+        } else if (strcmp(arg, "--ber") == 0 && has_value) {
+            opts->bit_error_rate = atof(argv[++i]);
+        } else if (strcmp(arg, "--ack-drop") == 0 && has_value) {
+            opts->ack_drop_rate = atof(argv[++i]);
+        } else if (strcmp(arg, "--ids") == 0 && has_value) {
+            opts->ids_learn_frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--ids-bench") == 0 && has_value) {
+            opts->ids_bench = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(arg, "--shm") == 0 && has_value) {
+            opts->shm_name = argv[++i];
+        } else if (strcmp(arg, "--bridge") == 0) {
+            opts->shm_bridge = true;
+        } else {
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    // The paced loop never services the shm ring; client frames would vanish
+    if (opts->shm_name && opts->realtime_s > 0) {
+        printf("[SHM] Error: --shm cannot be combined with --realtime\n");
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SimOptions opts;
+    if (!parse_options(argc, argv, &opts)) {
+        return 1;
+    }
+
+    SIM_Init(opts.seed_set ? opts.seed : (uint32_t)time(NULL),
+             (uint64_t)time(NULL) * 1000);
+    
+    if (opts.archive_bench > 0) {
+        run_archive_bench(opts.archive_bench);
+        return 0;
+    }
+    if (opts.loadtest_s > 0) {
+        return run_loadtest(&opts) ? 0 : 1;
+    }
+    if (opts.ids_bench > 0) {
+        return run_ids_bench(opts.ids_bench) ? 0 : 1;
+    }
     signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);  // Still unlinks the shm segment on kill
     
     DTC_Init(&dtc_mgr);
-    JSON_Init("can_data.json");
     
     CANBus bus;
     CANBus_Init(&bus);
@@ -143,6 +765,51 @@ int main(void) {
     ECU_Init(&brake_ecu, "Brake-ECU", ECU_BRAKE_SYSTEM);
     ECU_Init(&body_ecu, "Body-ECU", ECU_BODY_CONTROL);
     ECU_Init(&infotainment_ecu, "Infotainment-ECU", ECU_INFOTAINMENT);
+    ECUNode* nodes[] = {&engine_ecu, &brake_ecu, &body_ecu, &infotainment_ecu};
+    int node_count = (int)(sizeof(nodes) / sizeof(nodes[0]));
+    
+    // Set up before a restore: the seed draw is then overwritten with the
+    // restored RNG state, and the restore brings back the injector's own stream
+    FaultInjector faults;
+    if (opts.bit_error_rate > 0.0 || opts.ack_drop_rate > 0.0) {
+        FAULT_Init(&faults, opts.bit_error_rate, opts.ack_drop_rate, SIM_Rand() | 1ULL);
+        bus.faults = &faults;
+    }
+    
+    IDSDetector* detector = NULL;
+    if (opts.ids_learn_frames > 0) {
+        IDS_Init(&ids, &dtc_mgr, opts.ids_learn_frames);
+        CANBus_AttachMonitor(&bus, IDS_Monitor, &ids);
+        detector = &ids;
+    }
+    
+    uint32_t cycle = 0;
+    if (opts.checkpoint_load) {
+        const SimSnapshot* snap = Checkpoint_Map(opts.checkpoint_load);
+        if (!snap || !Checkpoint_Restore(snap, &bus, nodes, node_count, &dtc_mgr, detector, &cycle)) {
+            Checkpoint_Unmap(snap);
+            return 1;
+        }
+        Checkpoint_Unmap(snap);
+        printf("[CKPT] Restored cycle %u from %s\n", cycle, opts.checkpoint_load);
+        // Reseeding forks a new variant; otherwise the run replays exactly
+        if (opts.seed_set) {
+            SIM_Seed(opts.seed);
+        }
+    }
+    
+    if (opts.shm_name) {
+        if (!SHM_ServerCreate(&shm, opts.shm_name)) {
+            return 1;
+        }
+        CANBus_AttachMonitor(&bus, SHM_Monitor, &shm);
+        printf("[SHM] External ECUs can attach to %s\n", shm.name);
+    }
+    
+    JSON_Init("can_data.json");
+    if (opts.archive) {
+        ARC_Init(opts.archive);
+    }
     
     printf("\n");
     printf("================================================\n");
@@ -157,13 +824,23 @@ int main(void) {
     printf("\nPress Ctrl+C to stop...\n");
     printf("Dashboard: Open dashboard.html in your browser\n\n");
     
-    int cycle = 0;
-    while (keep_running && cycle < 12) {
+    bool cycle_mode = true;
+    if (opts.realtime_s > 0) {
+        run_realtime(&opts, &bus, &engine_ecu, &brake_ecu, &body_ecu, &infotainment_ecu);
+        cycle_mode = false;
+    } else if (opts.shm_name && opts.shm_bridge) {
+        run_shm_bridge(&bus, &infotainment_ecu);
+        cycle_mode = false;
+    }
+    
+    bool ids_learning = (opts.ids_learn_frames > 0) && ids.learning;
+    uint32_t last_cycle = cycle_mode ? cycle + (uint32_t)opts.cycles : cycle;
+    while (keep_running && cycle < last_cycle) {
         cycle++;
-        printf("\n=== Cycle %d ===\n", cycle);
+        printf("\n=== Cycle %u ===\n", cycle);
         
         // 20% chance of collision simulation
-        if (rand() % 100 < 20) {
+        if (SIM_Rand() % 100 < 20) {
             CANFrame engine_frame = create_engine_frame();
             CANFrame brake_frame = create_brake_frame();
             simulate_arbitration(&engine_ecu, &brake_ecu, &bus, 
@@ -171,33 +848,44 @@ int main(void) {
             
             // Body ECU sends normally
             CANFrame body_frame = create_body_frame();
-            ECU_SendFrame(&body_ecu, &bus, &body_frame);
-            JSON_LogFrame(&body_frame, body_ecu.name);
+            if (ECU_SendFrame(&body_ecu, &bus, &body_frame)) {
+                log_frame(&body_frame, body_ecu.name);
+            }
         } else {
             // Normal transmission
             printf(">> Transmission Phase:\n");
             CANFrame engine_frame = create_engine_frame();
-            ECU_SendFrame(&engine_ecu, &bus, &engine_frame);
-            JSON_LogFrame(&engine_frame, engine_ecu.name);
+            if (ECU_SendFrame(&engine_ecu, &bus, &engine_frame)) {
+                log_frame(&engine_frame, engine_ecu.name);
+            }
             
             // Random DTC generation
-            if (rand() % 100 < 10) {
+            if (SIM_Rand() % 100 < 10) {
                 printf("  [%s] [!] Engine misfire detected!\n", engine_ecu.name);
                 DTC_Add(&dtc_mgr, DTC_ENGINE_MISFIRE, "Random cylinder misfire detected");
             }
             
             CANFrame brake_frame = create_brake_frame();
-            ECU_SendFrame(&brake_ecu, &bus, &brake_frame);
-            JSON_LogFrame(&brake_frame, brake_ecu.name);
+            if (ECU_SendFrame(&brake_ecu, &bus, &brake_frame)) {
+                log_frame(&brake_frame, brake_ecu.name);
+            }
             
-            if (rand() % 100 < 3) {
+            if (SIM_Rand() % 100 < 3) {
                 printf("  [%s] [!] Low brake pressure detected!\n", brake_ecu.name);
                 DTC_Add(&dtc_mgr, DTC_BRAKE_PRESSURE_LOW, "Brake pressure below threshold");
             }
             
             CANFrame body_frame = create_body_frame();
-            ECU_SendFrame(&body_ecu, &bus, &body_frame);
-            JSON_LogFrame(&body_frame, body_ecu.name);
+            if (ECU_SendFrame(&body_ecu, &bus, &body_frame)) {
+                log_frame(&body_frame, body_ecu.name);
+            }
+        }
+        
+        if (opts.shm_name) {
+            int external = service_shm_clients(&bus);
+            if (external > 0) {
+                printf(">> %d frame(s) from external ECUs\n", external);
+            }
         }
         
         printf("\n>> Reception Phase:\n");
@@ -206,13 +894,37 @@ int main(void) {
         process_messages(&brake_ecu, &bus);
         process_messages(&body_ecu, &bus);
         
-        sleep(2);
+        if (ids_learning && !ids.learning) {
+            printf("[IDS] Learning complete, detection active\n");
+            ids_learning = false;
+        }
+        
+        // The bus idles between cycles, far longer than the 128 recessive
+        // sequences a bus-off node needs to recover
+        for (int i = 0; i < node_count; i++) {
+            CANERR_OnRecessiveSequence(&nodes[i]->err, CAN_BUS_OFF_RECOVERY);
+        }
+        
+        SIM_AdvanceTime(CYCLE_PERIOD_MS);
+        if (!opts.fast) {
+            sleep(CYCLE_PERIOD_MS / 1000);
+        }
+    }
+    
+    if (opts.checkpoint_save) {
+        SimSnapshot snap;
+        Checkpoint_Capture(&snap, &bus, nodes, node_count, &dtc_mgr, detector, cycle);
+        Checkpoint_Save(opts.checkpoint_save, &snap);
     }
     
     // Log final statistics
     ECUNode all_ecus[] = {engine_ecu, brake_ecu, body_ecu, infotainment_ecu};
     JSON_LogStats(&bus, all_ecus, 4);
     JSON_Close();
+    ARC_Close();
+    if (opts.shm_name) {
+        SHM_Close(&shm);
+    }
     
     printf("\n\n");
     printf("================================================\n");
@@ -228,6 +940,10 @@ int main(void) {
     printf("\n");
     CANBus_PrintStats(&bus);
     
+    if (opts.ids_learn_frames > 0) {
+        IDS_PrintStats(&ids);
+    }
+    
     printf("\n");
     DTC_PrintAll(&dtc_mgr);
     
@@ -0,0 +1,259 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include "rt_scheduler.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/timerfd.h>
+#endif
+
+#define NS_PER_SEC 1000000000ULL
+#define RT_START_DELAY_NS 10000000ULL   // First release 10 ms after start
+
+void RT_Init(RTScheduler* sched, int cpu, int fifo_priority) {
+    memset(sched, 0, sizeof(RTScheduler));
+    sched->cpu = cpu;
+    sched->fifo_priority = fifo_priority;
+}
+
+bool RT_AddTask(RTScheduler* sched, const char* name, uint16_t can_id,
+                uint32_t period_us, RTReleaseFn release, void* ctx) {
+    if (sched->task_count >= RT_MAX_TASKS || period_us == 0) {
+        printf("[RT] Error: Cannot add task %s\n", name);
+        return false;
+    }
+
+    RTTask* task = &sched->tasks[sched->task_count];
+    memset(task, 0, sizeof(RTTask));
+    strncpy(task->name, name, RT_TASK_NAME_LEN - 1);
+    task->can_id = can_id;
+    task->period_us = period_us;
+    task->release = release;
+    task->ctx = ctx;
+    task->jitter_min_ns = INT64_MAX;
+    task->fd = -1;
+    sched->task_count++;
+    return true;
+}
+
+void RT_PrintStats(const RTScheduler* sched) {
+    printf("\n========================================\n");
+    printf("      REAL-TIME PACING STATISTICS       \n");
+    printf("========================================\n");
+    printf("%-12s %6s %8s %9s %9s %9s %9s %9s\n",
+           "Message", "ID", "Period", "Releases", "Jit min", "Jit avg", "Jit max", "Misses");
+    printf("%-12s %6s %8s %9s %9s %9s %9s %9s\n",
+           "", "", "(us)", "", "(us)", "(us)", "(us)", "");
+    for (int i = 0; i < sched->task_count; i++) {
+        const RTTask* task = &sched->tasks[i];
+        double min_us = task->releases ? (double)task->jitter_min_ns / 1000.0 : 0.0;
+        double avg_us = task->releases ?
+            (double)task->jitter_sum_ns / (double)task->releases / 1000.0 : 0.0;
+        double max_us = task->releases ? (double)task->jitter_max_ns / 1000.0 : 0.0;
+        printf("%-12s 0x%03X %8u %9llu %9.1f %9.1f %9.1f %9llu\n",
+               task->name, task->can_id, task->period_us,
+               (unsigned long long)task->releases, min_us, avg_us, max_us,
+               (unsigned long long)task->deadline_misses);
+    }
+    printf("========================================\n");
+}
+
+#ifdef __linux__
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+static struct timespec to_timespec(uint64_t ns) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ns / NS_PER_SEC);
+    ts.tv_nsec = (long)(ns % NS_PER_SEC);
+    return ts;
+}
+
+// Settings in force before RT_Run, put back when it returns
+typedef struct {
+    cpu_set_t affinity;
+    struct sched_param param;
+    int policy;
+    bool affinity_changed;
+    bool policy_changed;
+    bool memory_locked;
+} RTPreviousPolicy;
+
+// Pinning and SCHED_FIFO are best effort: without the privileges we still
+// run, just with worse jitter.
+static void apply_realtime_policy(const RTScheduler* sched, RTPreviousPolicy* prev) {
+    memset(prev, 0, sizeof(RTPreviousPolicy));
+    if (sched->cpu >= 0 && sched_getaffinity(0, sizeof(prev->affinity), &prev->affinity) == 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(sched->cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            printf("[RT] Warning: Cannot pin to CPU %d (%s)\n", sched->cpu, strerror(errno));
+        } else {
+            prev->affinity_changed = true;
+        }
+    }
+    if (sched->fifo_priority > 0) {
+        prev->policy = sched_getscheduler(0);
+        if (prev->policy >= 0 && sched_getparam(0, &prev->param) == 0) {
+            struct sched_param param;
+            memset(&param, 0, sizeof(param));
+            param.sched_priority = sched->fifo_priority;
+            if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+                printf("[RT] Warning: SCHED_FIFO unavailable (%s)\n", strerror(errno));
+            } else {
+                prev->policy_changed = true;
+            }
+        }
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            printf("[RT] Warning: Cannot lock memory (%s)\n", strerror(errno));
+        } else {
+            prev->memory_locked = true;
+        }
+    }
+}
+
+// Whatever runs after the timed loop (logging, summaries) runs as before
+static void restore_previous_policy(const RTPreviousPolicy* prev) {
+    if (prev->policy_changed && sched_setscheduler(0, prev->policy, &prev->param) != 0) {
+        printf("[RT] Warning: Cannot restore scheduling policy (%s)\n", strerror(errno));
+    }
+    if (prev->affinity_changed &&
+        sched_setaffinity(0, sizeof(prev->affinity), &prev->affinity) != 0) {
+        printf("[RT] Warning: Cannot restore CPU affinity (%s)\n", strerror(errno));
+    }
+    if (prev->memory_locked) {
+        munlockall();
+    }
+}
+
+static void close_timers(RTScheduler* sched, int epfd) {
+    for (int i = 0; i < sched->task_count; i++) {
+        if (sched->tasks[i].fd >= 0) {
+            close(sched->tasks[i].fd);
+            sched->tasks[i].fd = -1;
+        }
+    }
+    if (epfd >= 0) close(epfd);
+}
+
+static bool run_tasks(RTScheduler* sched, uint32_t duration_ms,
+                      volatile sig_atomic_t* keep_running) {
+    int epfd = epoll_create1(0);
+    if (epfd < 0) {
+        printf("[RT] Error: epoll_create1 failed (%s)\n", strerror(errno));
+        return false;
+    }
+
+    // All tasks share one absolute start so their phases stay fixed
+    uint64_t start_ns = monotonic_ns() + RT_START_DELAY_NS;
+    uint64_t end_ns = start_ns + (uint64_t)duration_ms * 1000000ULL;
+
+    for (int i = 0; i < sched->task_count; i++) {
+        RTTask* task = &sched->tasks[i];
+        uint64_t period_ns = (uint64_t)task->period_us * 1000ULL;
+
+        task->fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        if (task->fd < 0) {
+            printf("[RT] Error: timerfd_create failed (%s)\n", strerror(errno));
+            close_timers(sched, epfd);
+            return false;
+        }
+
+        struct itimerspec spec;
+        spec.it_value = to_timespec(start_ns);
+        spec.it_interval = to_timespec(period_ns);
+        task->next_release_ns = start_ns;
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.u32 = (uint32_t)i;
+
+        if (timerfd_settime(task->fd, TFD_TIMER_ABSTIME, &spec, NULL) != 0 ||
+            epoll_ctl(epfd, EPOLL_CTL_ADD, task->fd, &ev) != 0) {
+            printf("[RT] Error: Cannot arm timer for %s (%s)\n", task->name, strerror(errno));
+            close_timers(sched, epfd);
+            return false;
+        }
+    }
+
+    printf("[RT] Running %d periodic messages for %u ms\n", sched->task_count, duration_ms);
+
+    struct epoll_event events[RT_MAX_TASKS];
+    while ((!keep_running || *keep_running) && monotonic_ns() < end_ns) {
+        int ready = epoll_wait(epfd, events, RT_MAX_TASKS, 100);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            printf("[RT] Error: epoll_wait failed (%s)\n", strerror(errno));
+            break;
+        }
+
+        for (int e = 0; e < ready; e++) {
+            RTTask* task = &sched->tasks[events[e].data.u32];
+            uint64_t expirations = 0;
+            if (read(task->fd, &expirations, sizeof(expirations)) != sizeof(expirations) ||
+                expirations == 0) {
+                continue;
+            }
+
+            uint64_t period_ns = (uint64_t)task->period_us * 1000ULL;
+            uint64_t now_ns = monotonic_ns();
+
+            // More than one expiration means we slept through whole periods;
+            // the skipped releases are counted as missed deadlines and the
+            // latest one is what gets released now.
+            task->deadline_misses += expirations - 1;
+            uint64_t release_ns = task->next_release_ns + (expirations - 1) * period_ns;
+            task->next_release_ns = release_ns + period_ns;
+
+            int64_t jitter = (int64_t)(now_ns - release_ns);
+            if (jitter < task->jitter_min_ns) task->jitter_min_ns = jitter;
+            if (jitter > task->jitter_max_ns) task->jitter_max_ns = jitter;
+            task->jitter_sum_ns += jitter;
+            task->releases++;
+
+            task->release(task->ctx, release_ns);
+
+            if (monotonic_ns() > release_ns + period_ns) {
+                task->deadline_misses++;
+            }
+        }
+    }
+
+    close_timers(sched, epfd);
+    return true;
+}
+
+bool RT_Run(RTScheduler* sched, uint32_t duration_ms, volatile sig_atomic_t* keep_running) {
+    RTPreviousPolicy prev;
+    apply_realtime_policy(sched, &prev);
+    bool ok = run_tasks(sched, duration_ms, keep_running);
+    restore_previous_policy(&prev);
+    return ok;
+}
+
+#else
+
+bool RT_Run(RTScheduler* sched, uint32_t duration_ms, volatile sig_atomic_t* keep_running) {
+    (void)sched;
+    (void)duration_ms;
+    (void)keep_running;
+    printf("[RT] Error: Real-time mode requires Linux (timerfd/epoll)\n");
+    return false;
+}
+
+#endif
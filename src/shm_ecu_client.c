@@ -0,0 +1,87 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "can_frame.h"
+#include "shm_transport.h"
+
+// Example external ECU: attaches to a running simulator
+// (./can_simulator.exe --shm canbus --bridge), sends ping frames and
+// measures the round trip until each one comes back from bus delivery.
+// Pings carry a per-client tag, so several clients can share one ping ID.
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int main(int argc, char* argv[]) {
+    const char* name = (argc > 1) ? argv[1] : "canbus";
+    int pings = (argc > 2) ? atoi(argv[2]) : 10000;
+    uint16_t ping_id = (argc > 3) ? (uint16_t)strtoul(argv[3], NULL, 0) : 0x1F0;
+
+    SHMTransport shm;
+    if (!SHM_ClientAttach(&shm, name)) {
+        return 1;
+    }
+    printf("=== Shared-Memory ECU Client ===\n");
+    printf("Segment: /%s  Ping ID: 0x%03X  Pings: %d\n\n", name, ping_id, pings);
+
+    uint64_t rtt_min = UINT64_MAX, rtt_max = 0, rtt_sum = 0;
+    int completed = 0, other_frames = 0, reclaimed = 0;
+    uint16_t tag = (uint16_t)getpid();
+
+    for (int i = 0; i < pings; i++) {
+        // Build the frame directly in the shared ring (zero copy)
+        uint32_t ticket;
+        CANFrame* frame = SHM_TxReserve(&shm, &ticket);
+        if (!frame) {
+            printf("[Client] TX ring full, stopping\n");
+            break;
+        }
+        uint8_t data[4] = {(uint8_t)(tag >> 8), (uint8_t)tag, (uint8_t)(i >> 8), (uint8_t)i};
+        CAN_SetData(frame, ping_id, data, 4);
+        uint64_t sent = now_ns();
+        if (!SHM_TxCommit(&shm, ticket)) {
+            reclaimed++;  // Held the slot past the server's timeout
+            continue;
+        }
+
+        // Wait for our ping to come back (other traffic is counted and skipped)
+        for (;;) {
+            const CANFrame* rx = SHM_RxPeek(&shm, 1000);
+            if (!rx) {
+                printf("[Client] Timeout waiting for ping %d\n", i);
+                goto done;
+            }
+            bool mine = rx->id == ping_id && rx->dlc == 4 &&
+                        memcmp(rx->data, data, sizeof(data)) == 0;
+            if (SHM_RxRelease(&shm) && mine) break;
+            other_frames++;
+        }
+
+        uint64_t rtt = now_ns() - sent;
+        if (rtt < rtt_min) rtt_min = rtt;
+        if (rtt > rtt_max) rtt_max = rtt;
+        rtt_sum += rtt;
+        completed++;
+    }
+
+done:
+    if (completed > 0) {
+        printf("Round trips:     %d\n", completed);
+        printf("RTT min/avg/max: %.1f / %.1f / %.1f us\n",
+               rtt_min / 1000.0, rtt_sum / 1000.0 / completed, rtt_max / 1000.0);
+    }
+    printf("Other frames:    %d\n", other_frames);
+    if (reclaimed > 0) {
+        printf("Reclaimed pings: %d\n", reclaimed);
+    }
+    printf("Lost frames:     %llu\n", (unsigned long long)shm.rx_lost);
+
+    SHM_Close(&shm);
+    return 0;
+}
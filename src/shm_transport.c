@@ -0,0 +1,343 @@
+#include "shm_transport.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#endif
+
+#define RING_MASK (SHM_RING_SIZE - 1)
+
+#ifdef __linux__
+
+// ---- Futex helpers (shared, not FUTEX_PRIVATE: waiters are other processes) ----
+
+static void futex_wait(uint32_t* addr, uint32_t expected, int timeout_ms) {
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+    syscall(SYS_futex, addr, FUTEX_WAIT, expected, timeout_ms >= 0 ? &ts : NULL, NULL, 0);
+}
+
+static void futex_wake(uint32_t* addr) {
+    syscall(SYS_futex, addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+// True if the segment's server process is still running
+static bool segment_in_use(const char* name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return false;
+
+    bool live = false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(SHMSegment)) {
+        void* base = mmap(NULL, sizeof(SHMSegment), PROT_READ, MAP_SHARED, fd, 0);
+        if (base != MAP_FAILED) {
+            pid_t pid = (pid_t)__atomic_load_n(&((SHMSegment*)base)->server_pid, __ATOMIC_ACQUIRE);
+            live = pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+            munmap(base, sizeof(SHMSegment));
+        }
+    }
+    close(fd);
+    return live;
+}
+
+static bool map_segment(SHMTransport* shm, const char* name, bool create) {
+    memset(shm, 0, sizeof(SHMTransport));
+    snprintf(shm->name, SHM_NAME_LEN, "/%s", name[0] == '/' ? name + 1 : name);
+
+    int flags = create ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR;
+    int fd = shm_open(shm->name, flags, 0600);
+    if (fd < 0 && create && errno == EEXIST) {
+        // Never reset a live segment under its clients
+        if (segment_in_use(shm->name)) {
+            printf("[SHM] Error: %s is in use by a running simulator\n", shm->name);
+            return false;
+        }
+        printf("[SHM] Removing stale segment %s\n", shm->name);
+        shm_unlink(shm->name);
+        fd = shm_open(shm->name, flags, 0600);
+    }
+    if (fd < 0) {
+        printf("[SHM] Error: Cannot open %s (%s)\n", shm->name, strerror(errno));
+        return false;
+    }
+    shm->server = create;
+
+    if (create && ftruncate(fd, sizeof(SHMSegment)) != 0) {
+        printf("[SHM] Error: Cannot size %s (%s)\n", shm->name, strerror(errno));
+        close(fd);
+        shm_unlink(shm->name);
+        return false;
+    }
+    // Mapping past the end of a short object would SIGBUS on first access
+    struct stat st;
+    if (!create && (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(SHMSegment))) {
+        printf("[SHM] Error: %s is not a compatible bus segment\n", shm->name);
+        close(fd);
+        return false;
+    }
+
+    void* base = mmap(NULL, sizeof(SHMSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        printf("[SHM] Error: Cannot map %s (%s)\n", shm->name, strerror(errno));
+        if (create) shm_unlink(shm->name);
+        return false;
+    }
+    shm->seg = (SHMSegment*)base;
+    return true;
+}
+
+// ---- Simulator side ----
+
+bool SHM_ServerCreate(SHMTransport* shm, const char* name) {
+    if (!map_segment(shm, name, true)) return false;
+
+    SHMSegment* seg = shm->seg;
+    __atomic_store_n(&seg->server_pid, (uint32_t)getpid(), __ATOMIC_RELEASE);
+    for (uint32_t i = 0; i < SHM_RING_SIZE; i++) {
+        seg->tx[i].seq = i;
+        seg->rx[i].seq = 0;
+    }
+    seg->ring_size = SHM_RING_SIZE;
+    seg->frame_size = sizeof(CANFrame);
+    seg->version = SHM_VERSION;
+    // Magic last: clients only attach to a fully initialised segment
+    __atomic_store_n(&seg->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+    return true;
+}
+
+// True once the tail slot has been reserved but uncommitted for too long
+static bool tx_slot_abandoned(SHMTransport* shm, uint32_t pos) {
+    uint64_t now = monotonic_ms();
+    if (!shm->tx_stalled || shm->tx_stalled_pos != pos) {
+        shm->tx_stalled = true;
+        shm->tx_stalled_pos = pos;
+        shm->tx_stalled_since_ms = now;
+        return false;
+    }
+    return now - shm->tx_stalled_since_ms >= SHM_TX_ABANDON_MS;
+}
+
+bool SHM_ServerPoll(SHMTransport* shm, CANFrame* frame) {
+    SHMSegment* seg = shm->seg;
+    uint32_t pos = seg->tx_tail;
+    SHMSlot* slot = &seg->tx[pos & RING_MASK];
+
+    uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+    if (seq != pos + 1) {
+        // Reserved (tx_head moved past it) but never committed
+        if (seq != pos || __atomic_load_n(&seg->tx_head, __ATOMIC_ACQUIRE) == pos ||
+            !tx_slot_abandoned(shm, pos)) {
+            return false;
+        }
+        // Skip it; the CAS fails if the client committed after all
+        if (!__atomic_compare_exchange_n(&slot->seq, &seq, pos + SHM_RING_SIZE, false,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return SHM_ServerPoll(shm, frame);
+        }
+        shm->tx_stalled = false;
+        shm->tx_abandoned++;
+        __atomic_store_n(&seg->tx_tail, pos + 1, __ATOMIC_RELEASE);
+        printf("[SHM] Warning: TX slot %u uncommitted for %d ms, skipped (client died?)\n",
+               pos, SHM_TX_ABANDON_MS);
+        return SHM_ServerPoll(shm, frame);
+    }
+    shm->tx_stalled = false;
+    *frame = slot->frame;
+    // Hand the slot back to producers one lap later
+    __atomic_store_n(&slot->seq, pos + SHM_RING_SIZE, __ATOMIC_RELEASE);
+    __atomic_store_n(&seg->tx_tail, pos + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool SHM_ServerWait(SHMTransport* shm, int timeout_ms) {
+    SHMSegment* seg = shm->seg;
+    uint32_t signal = __atomic_load_n(&seg->tx_signal, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&seg->tx_waiters, 1, __ATOMIC_SEQ_CST);
+
+    SHMSlot* slot = &seg->tx[seg->tx_tail & RING_MASK];
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != seg->tx_tail + 1) {
+        futex_wait(&seg->tx_signal, signal, timeout_ms);
+    }
+
+    __atomic_sub_fetch(&seg->tx_waiters, 1, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) == seg->tx_tail + 1;
+}
+
+// Seqlock publish: readers see seq == pos + 1 only while the slot holds frame pos
+void SHM_ServerPublish(SHMTransport* shm, const CANFrame* frame) {
+    SHMSegment* seg = shm->seg;
+    uint32_t pos = seg->rx_head;
+    SHMSlot* slot = &seg->rx[pos & RING_MASK];
+
+    __atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    slot->frame = *frame;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&seg->rx_head, pos + 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&seg->rx_waiters, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake(&seg->rx_head);
+    }
+}
+
+void SHM_Monitor(void* ctx, const CANFrame* frame) {
+    SHM_ServerPublish((SHMTransport*)ctx, frame);
+}
+
+// ---- Client side ----
+
+bool SHM_ClientAttach(SHMTransport* shm, const char* name) {
+    if (!map_segment(shm, name, false)) return false;
+
+    SHMSegment* seg = shm->seg;
+    if (__atomic_load_n(&seg->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC ||
+        seg->version != SHM_VERSION || seg->ring_size != SHM_RING_SIZE ||
+        seg->frame_size != sizeof(CANFrame)) {
+        printf("[SHM] Error: %s is not a compatible bus segment\n", shm->name);
+        SHM_Close(shm);
+        return false;
+    }
+    // Start with the next published frame
+    shm->rx_pos = __atomic_load_n(&seg->rx_head, __ATOMIC_ACQUIRE);
+    return true;
+}
+
+CANFrame* SHM_TxReserve(SHMTransport* shm, uint32_t* ticket) {
+    SHMSegment* seg = shm->seg;
+    uint32_t pos = __atomic_load_n(&seg->tx_head, __ATOMIC_RELAXED);
+
+    for (;;) {
+        SHMSlot* slot = &seg->tx[pos & RING_MASK];
+        int32_t diff = (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&seg->tx_head, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                *ticket = pos;
+                return &slot->frame;
+            }
+        } else if (diff < 0) {
+            return NULL;  // Ring full, server is behind
+        } else {
+            pos = __atomic_load_n(&seg->tx_head, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+// False if the server already reclaimed the slot (reservation held too long)
+bool SHM_TxCommit(SHMTransport* shm, uint32_t ticket) {
+    SHMSegment* seg = shm->seg;
+    uint32_t expected = ticket;
+    if (!__atomic_compare_exchange_n(&seg->tx[ticket & RING_MASK].seq, &expected, ticket + 1,
+                                     false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        return false;
+    }
+    __atomic_add_fetch(&seg->tx_signal, 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&seg->tx_waiters, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake(&seg->tx_signal);
+    }
+    return true;
+}
+
+bool SHM_Transmit(SHMTransport* shm, const CANFrame* frame) {
+    uint32_t ticket;
+    CANFrame* slot = SHM_TxReserve(shm, &ticket);
+    if (!slot) return false;
+    *slot = *frame;
+    return SHM_TxCommit(shm, ticket);
+}
+
+const CANFrame* SHM_RxPeek(SHMTransport* shm, int timeout_ms) {
+    SHMSegment* seg = shm->seg;
+
+    for (;;) {
+        uint32_t head = __atomic_load_n(&seg->rx_head, __ATOMIC_ACQUIRE);
+        if (head == shm->rx_pos && timeout_ms != 0) {
+            __atomic_add_fetch(&seg->rx_waiters, 1, __ATOMIC_SEQ_CST);
+            futex_wait(&seg->rx_head, shm->rx_pos, timeout_ms);
+            __atomic_sub_fetch(&seg->rx_waiters, 1, __ATOMIC_SEQ_CST);
+            head = __atomic_load_n(&seg->rx_head, __ATOMIC_ACQUIRE);
+        }
+        if (head == shm->rx_pos) {
+            return NULL;
+        }
+
+        // Lapped by the server: skip to the oldest frame still in the ring
+        if (head - shm->rx_pos > SHM_RING_SIZE) {
+            shm->rx_lost += head - shm->rx_pos - SHM_RING_SIZE;
+            shm->rx_pos = head - SHM_RING_SIZE;
+        }
+
+        SHMSlot* slot = &seg->rx[shm->rx_pos & RING_MASK];
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) == shm->rx_pos + 1) {
+            return &slot->frame;
+        }
+        // Being overwritten right now: count it and try the next one
+        shm->rx_lost++;
+        shm->rx_pos++;
+    }
+}
+
+bool SHM_RxRelease(SHMTransport* shm) {
+    SHMSlot* slot = &shm->seg->rx[shm->rx_pos & RING_MASK];
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    bool intact = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == shm->rx_pos + 1;
+    if (!intact) shm->rx_lost++;
+    shm->rx_pos++;
+    return intact;
+}
+
+void SHM_Close(SHMTransport* shm) {
+    if (shm->seg) {
+        munmap(shm->seg, sizeof(SHMSegment));
+        shm->seg = NULL;
+    }
+    if (shm->server) {
+        shm_unlink(shm->name);
+        shm->server = false;
+    }
+}
+
+#else
+
+bool SHM_ServerCreate(SHMTransport* shm, const char* name) {
+    (void)name;
+    memset(shm, 0, sizeof(SHMTransport));
+    printf("[SHM] Error: Shared-memory transport requires Linux\n");
+    return false;
+}
+
+bool SHM_ClientAttach(SHMTransport* shm, const char* name) {
+    return SHM_ServerCreate(shm, name);
+}
+
+bool SHM_ServerPoll(SHMTransport* shm, CANFrame* frame) { (void)shm; (void)frame; return false; }
+bool SHM_ServerWait(SHMTransport* shm, int timeout_ms) { (void)shm; (void)timeout_ms; return false; }
+void SHM_ServerPublish(SHMTransport* shm, const CANFrame* frame) { (void)shm; (void)frame; }
+void SHM_Monitor(void* ctx, const CANFrame* frame) { (void)ctx; (void)frame; }
+CANFrame* SHM_TxReserve(SHMTransport* shm, uint32_t* ticket) { (void)shm; (void)ticket; return NULL; }
+bool SHM_TxCommit(SHMTransport* shm, uint32_t ticket) { (void)shm; (void)ticket; return false; }
+bool SHM_Transmit(SHMTransport* shm, const CANFrame* frame) { (void)shm; (void)frame; return false; }
+const CANFrame* SHM_RxPeek(SHMTransport* shm, int timeout_ms) { (void)shm; (void)timeout_ms; return NULL; }
+bool SHM_RxRelease(SHMTransport* shm) { (void)shm; return false; }
+void SHM_Close(SHMTransport* shm) { (void)shm; }
+
+#endif
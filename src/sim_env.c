@@ -0,0 +1,45 @@
+#include "sim_env.h"
+
+static SimEnv sim_env = { 0, 0x2545F491u, 0 };
+
+void SIM_Init(uint32_t seed, uint64_t start_ms) {
+    SIM_Seed(seed);
+    sim_env.clock_ms = start_ms;
+}
+
+void SIM_Seed(uint32_t seed) {
+    // xorshift32 gets stuck at zero, so remap it
+    sim_env.rng_state = seed ? seed : 0x2545F491u;
+}
+
+int SIM_Rand(void) {
+    uint32_t x = sim_env.rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim_env.rng_state = x;
+    return (int)(x & SIM_RAND_MAX);
+}
+
+uint32_t SIM_GetTimeMs(void) {
+    return (uint32_t)sim_env.clock_ms;
+}
+
+uint64_t SIM_GetTimeMs64(void) {
+    return sim_env.clock_ms;
+}
+
+void SIM_AdvanceTime(uint32_t ms) {
+    sim_env.clock_ms += ms;
+}
+
+void SIM_GetState(SimEnv* env) {
+    *env = sim_env;
+}
+
+void SIM_SetState(const SimEnv* env) {
+    sim_env = *env;
+    if (sim_env.rng_state == 0) {
+        sim_env.rng_state = 0x2545F491u;
+    }
+}
@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "can_archive.h"
+
+#define TEST_FILE "test_archive.cnarc"
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-48s %s\n", what, ok ? "PASS" : "FAIL");
+    if (!ok) failures++;
+}
+
+static CANFrame make_frame(uint16_t id, uint32_t timestamp, uint8_t dlc, uint8_t value) {
+    CANFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.id = id;
+    frame.timestamp = timestamp;
+    frame.dlc = dlc;
+    for (int b = 0; b < dlc; b++) {
+        frame.data[b] = (uint8_t)(value + b);
+    }
+    return frame;
+}
+
+// Bytes beyond the DLC are not part of the frame
+static bool same_frame(const CANFrame* a, const CANFrame* b) {
+    return a->id == b->id && a->dlc == b->dlc && a->timestamp == b->timestamp &&
+           a->rtr == b->rtr && a->error == b->error &&
+           memcmp(a->data, b->data, a->dlc) == 0;
+}
+
+static bool block_round_trip(const CANFrame* frames, int count) {
+    uint64_t sequence[ARC_BLOCK_FRAMES];
+    uint64_t decoded_sequence[ARC_BLOCK_FRAMES];
+    CANFrame decoded[ARC_BLOCK_FRAMES];
+    uint8_t block[ARC_MAX_BLOCK_BYTES];
+
+    for (int i = 0; i < count; i++) {
+        sequence[i] = 1000 + 3 * (uint64_t)i;
+    }
+    size_t size = ARC_EncodeBlock(frames, sequence, count, block);
+    if (ARC_DecodeBlock(block, size, frames[0].id, decoded, decoded_sequence, count) != count) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        if (!same_frame(&frames[i], &decoded[i]) || sequence[i] != decoded_sequence[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Write frames through the streaming writer, read them back in order
+static bool file_round_trip(const CANFrame* frames, int count, uint64_t* blocks) {
+    ARCWriter* writer = (ARCWriter*)malloc(sizeof(ARCWriter));
+    ARCReader* reader = (ARCReader*)malloc(sizeof(ARCReader));
+    bool ok = writer && reader && ARC_OpenWriter(writer, TEST_FILE);
+
+    for (int i = 0; ok && i < count; i++) {
+        ok = ARC_WriteFrame(writer, &frames[i]);
+    }
+    if (writer && writer->file) {
+        ARC_CloseWriter(writer);
+    }
+
+    int decoded = 0;
+    if (ok && ARC_OpenReader(reader, TEST_FILE)) {
+        CANFrame frame;
+        while (ARC_ReadFrame(reader, &frame)) {
+            if (decoded >= count || !same_frame(&frame, &frames[decoded])) {
+                ok = false;
+            }
+            decoded++;
+        }
+        if (blocks) {
+            *blocks = 0;
+            for (int id = 0; id < ARC_ID_COUNT; id++) {
+                if (reader->columns[id]) *blocks += (uint64_t)reader->columns[id]->block_count;
+            }
+        }
+        ARC_CloseReader(reader);
+    } else {
+        ok = false;
+    }
+
+    free(writer);
+    free(reader);
+    remove(TEST_FILE);
+    return ok && decoded == count;
+}
+
+int main(void) {
+    CANFrame frames[2 * ARC_BLOCK_FRAMES + 1];
+    CANFrame decoded[4];
+    uint64_t sequence[4];
+    
+    printf("=== CAN Archive Codec Test ===\n\n");
+    
+    // Test 1: a run token at the start of a block
+    printf("Run tokens:\n");
+    // Timestamps 10, 20 | sequence 0, gap 1 | run of 2 with nothing to repeat
+    const uint8_t run_first[] = {0x0A, 0x14, 0x00, 0x03, 0x04};
+    check(ARC_DecodeBlock(run_first, sizeof(run_first), 0x100, decoded, sequence, 2) == -1,
+          "Payload run token first is rejected");
+    // Timestamps 10, 20 | sequence 0, run of 1 with no gap yet
+    const uint8_t seq_run_first[] = {0x0A, 0x14, 0x00, 0x02, 0x01, 0x00, 0x04};
+    check(ARC_DecodeBlock(seq_run_first, sizeof(seq_run_first), 0x100, decoded, sequence, 2) == -1,
+          "Sequence run token first is rejected");
+    // An empty first frame equals the zeroed XOR reference, but must not become a run
+    frames[0] = make_frame(0x100, 10, 0, 0);
+    frames[1] = make_frame(0x100, 20, 0, 0);
+    frames[2] = make_frame(0x100, 30, 0, 0);
+    check(block_round_trip(frames, 3), "Empty first frame encodes as a literal");
+    
+    // Test 2: a DLC change inside a run of unchanged bytes
+    printf("\nDLC changes:\n");
+    frames[0] = make_frame(0x120, 10, 2, 0x11);
+    frames[1] = make_frame(0x120, 20, 2, 0x11);
+    frames[2] = make_frame(0x120, 30, 1, 0x11);     // Same first byte, shorter
+    frames[2].data[1] = 0x12;                       // Stale byte beyond the DLC
+    frames[3] = make_frame(0x120, 40, 1, 0x11);
+    frames[4] = make_frame(0x120, 50, 2, 0x11);
+    frames[5] = make_frame(0x120, 60, 2, 0x11);
+    frames[5].rtr = true;                           // Same bytes, other control bits
+    frames[6] = make_frame(0x120, 70, 2, 0x11);
+    frames[6].error = true;
+    check(block_round_trip(frames, 7), "DLC and flag changes break the run");
+    
+    // Test 3: timestamps wrapping past 2^32 ms
+    printf("\nTimestamps:\n");
+    for (int i = 0; i < 20; i++) {
+        frames[i] = make_frame(0x300, 0xFFFFFFB0u + 10u * (uint32_t)i, 1, 0);
+    }
+    check(block_round_trip(frames, 20), "Steady period across the wrap");
+    frames[5].timestamp = 0;
+    frames[6].timestamp = 0xFFFFFFFFu;
+    check(block_round_trip(frames, 20), "Jumps back and forth across the wrap");
+    
+    // Test 4: exactly one full block
+    printf("\nBlock boundaries:\n");
+    for (int i = 0; i < 2 * ARC_BLOCK_FRAMES + 1; i++) {
+        frames[i] = make_frame(0x100, 10u * (uint32_t)i, 4, (uint8_t)(i / 7));
+    }
+    check(block_round_trip(frames, ARC_BLOCK_FRAMES), "256-frame block round trip");
+    uint64_t blocks = 0;
+    check(file_round_trip(frames, ARC_BLOCK_FRAMES, &blocks) && blocks == 1,
+          "256 frames write exactly one block");
+    check(file_round_trip(frames, ARC_BLOCK_FRAMES + 1, &blocks) && blocks == 2,
+          "257 frames write two blocks");
+    
+    // Test 5: interleaved IDs come back in capture order
+    printf("\nCapture order:\n");
+    int n = 0;
+    for (int tick = 0; n < 2 * ARC_BLOCK_FRAMES + 1; tick++) {
+        uint32_t ts = 2000u * (uint32_t)tick;           // Same timestamp per tick
+        frames[n++] = make_frame(0x300, ts, 1, (uint8_t)tick);
+        if (tick % 2 == 0 && n < 2 * ARC_BLOCK_FRAMES + 1) {
+            frames[n++] = make_frame(0x100, ts, 4, (uint8_t)tick);
+        }
+        if (tick == 3 && n < 2 * ARC_BLOCK_FRAMES + 1) {
+            frames[n++] = make_frame(0x7DF, ts, 8, 0x55);
+        }
+    }
+    check(file_round_trip(frames, n, &blocks), "Interleaved IDs keep their order");
+    
+    printf("\n%s (%d failure%s)\n", failures ? "FAILED" : "All tests passed",
+           failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
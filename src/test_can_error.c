@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include "can_error.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-48s %s\n", what, ok ? "PASS" : "FAIL");
+    if (!ok) failures++;
+}
+
+static void tx_errors(CANErrorCounters* err, int count, FaultType fault) {
+    for (int i = 0; i < count; i++) {
+        CANERR_OnTxError(err, fault);
+    }
+}
+
+int main(void) {
+    CANErrorCounters err;
+    
+    printf("=== CAN Error Confinement Test ===\n\n");
+    
+    // Test 1: TEC above 127 goes error-passive
+    printf("TEC limits:\n");
+    CANERR_Init(&err);
+    tx_errors(&err, 15, FAULT_BIT_ERROR);
+    check(err.tec == 120 && err.state == CAN_ERROR_ACTIVE, "TEC 120 stays error-active");
+    tx_errors(&err, 1, FAULT_BIT_ERROR);
+    check(err.tec == 128 && err.state == CAN_ERROR_PASSIVE, "TEC 128 goes error-passive");
+    
+    // Test 2: TEC above 255 goes bus-off
+    tx_errors(&err, 15, FAULT_BIT_ERROR);
+    check(err.tec == 248 && err.state == CAN_ERROR_PASSIVE, "TEC 248 stays error-passive");
+    tx_errors(&err, 1, FAULT_BIT_ERROR);
+    check(err.tec == 256 && err.state == CAN_BUS_OFF, "TEC 256 goes bus-off");
+    check(err.bus_off_events == 1 && !CANERR_CanTransmit(&err), "Bus-off node cannot transmit");
+    
+    // Test 3: error-passive transmitter keeps its TEC on an ACK error
+    printf("\nACK errors:\n");
+    CANERR_Init(&err);
+    tx_errors(&err, 2, FAULT_ACK_ERROR);
+    check(err.tec == 16, "Error-active: ACK error adds 8");
+    tx_errors(&err, 14, FAULT_BIT_ERROR);
+    tx_errors(&err, 5, FAULT_ACK_ERROR);
+    check(err.tec == 128 && err.state == CAN_ERROR_PASSIVE, "Error-passive: ACK error keeps TEC");
+    
+    // Test 4: REC drops back to 120 after a successful receive
+    printf("\nREC:\n");
+    CANERR_Init(&err);
+    for (int i = 0; i < 130; i++) {
+        CANERR_OnRxError(&err);
+    }
+    check(err.rec == 130 && err.state == CAN_ERROR_PASSIVE, "REC 130 goes error-passive");
+    CANERR_OnRxSuccess(&err);
+    check(err.rec == 120 && err.state == CAN_ERROR_ACTIVE, "Successful receive sets REC to 120");
+    CANERR_OnRxSuccess(&err);
+    check(err.rec == 119, "Then REC counts down by one");
+    
+    // Test 5: bus-off recovery after 128 sequences of 11 recessive bits
+    printf("\nBus-off recovery:\n");
+    CANERR_Init(&err);
+    tx_errors(&err, 32, FAULT_BIT_ERROR);
+    CANERR_OnRecessiveSequence(&err, 100);
+    CANERR_OnRecessiveSequence(&err, 27);
+    check(err.state == CAN_BUS_OFF && err.recovery_count == 127, "127 sequences: still bus-off");
+    CANERR_OnRecessiveSequence(&err, 1);
+    check(err.state == CAN_ERROR_ACTIVE && err.tec == 0 && err.rec == 0,
+          "128 sequences: error-active, counters cleared");
+    CANERR_OnTxSuccess(&err);
+    check(err.tec == 0 && CANERR_CanTransmit(&err), "Recovered node transmits again");
+    
+    printf("\n%s (%d failure%s)\n", failures ? "FAILED" : "All tests passed",
+           failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
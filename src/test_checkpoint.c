@@ -0,0 +1,157 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "checkpoint.h"
+
+#define TEST_FILE "test_checkpoint.ckpt"
+#define ECU_COUNT 3
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-48s %s\n", what, ok ? "PASS" : "FAIL");
+    if (!ok) failures++;
+}
+
+// Static storage, so struct padding starts out zeroed on both sides
+static CANBus bus, saved_bus;
+static ECUNode ecus[ECU_COUNT], saved_ecus[ECU_COUNT];
+static DTCManager dtc, saved_dtc;
+static FaultInjector faults;
+
+static ECUNode* nodes[ECU_COUNT] = {&ecus[0], &ecus[1], &ecus[2]};
+
+// A state with a wrapped bus queue, non-trivial error states and DTCs
+static void build_state(void) {
+    SIM_Init(42, 1760000000000ULL);
+    CANBus_Init(&bus);
+    FAULT_Init(&faults, 1e-3, 0.01, 0x1234567ULL);
+    bus.faults = &faults;
+
+    CANFrame frame;
+    for (int i = 0; i < MAX_BUS_QUEUE - 5; i++) {
+        uint8_t data[2] = {(uint8_t)i, (uint8_t)SIM_Rand()};
+        CAN_SetData(&frame, (uint16_t)(0x100 + i), data, 2);
+        CANBus_Transmit(&bus, &frame);
+        CANBus_Receive(&bus, &frame);
+    }
+    for (int i = 0; i < 10; i++) {
+        uint8_t data[8] = {1, 2, 3, 4, 5, 6, 7, (uint8_t)i};
+        CAN_SetData(&frame, (uint16_t)(0x200 + i), data, 8);
+        CANBus_Transmit(&bus, &frame);
+    }
+
+    ECU_Init(&ecus[0], "Engine-ECU", ECU_ENGINE_CONTROL);
+    ECU_Init(&ecus[1], "Brake-ECU", ECU_BRAKE_SYSTEM);
+    ECU_Init(&ecus[2], "Body-ECU", ECU_BODY_CONTROL);
+    ecus[0].frames_sent = 1234;
+    for (int i = 0; i < 17; i++) CANERR_OnTxError(&ecus[1].err, FAULT_BIT_ERROR);
+    for (int i = 0; i < 32; i++) CANERR_OnTxError(&ecus[2].err, FAULT_BIT_ERROR);
+    CANERR_OnRecessiveSequence(&ecus[2].err, 40);
+
+    DTC_Init(&dtc);
+    SIM_AdvanceTime(5000);
+    DTC_Add(&dtc, DTC_ENGINE_MISFIRE, "Random cylinder misfire detected");
+    DTC_Add(&dtc, DTC_BRAKE_PRESSURE_LOW, "Brake pressure below threshold");
+    uint32_t error_bit;
+    for (int i = 0; i < 1000; i++) FAULT_Inject(&faults, &frame, CAN_FRAME_BITS(8), &error_bit);
+}
+
+// Overwrite the live state, so a restore has to bring every field back
+static void scramble_state(void) {
+    SIM_Init(7, 0);
+    CANBus_Init(&bus);
+    bus.faults = &faults;
+    faults.rng = 99;
+    faults.bit_errors = 0;
+    faults.ack_errors = 0;
+    for (int i = 0; i < ECU_COUNT; i++) ECU_Init(&ecus[i], "Scrambled", ECU_INFOTAINMENT);
+    DTC_Init(&dtc);
+}
+
+static bool restore_copy(const SimSnapshot* image, void (*corrupt)(SimSnapshot*)) {
+    SimSnapshot* copy = (SimSnapshot*)malloc(sizeof(SimSnapshot));
+    if (!copy) return false;
+    *copy = *image;
+    corrupt(copy);
+    uint32_t cycle = 0;
+    bool ok = Checkpoint_Restore(copy, &bus, nodes, ECU_COUNT, &dtc, NULL, &cycle);
+    free(copy);
+    return ok;
+}
+
+static void bad_queue_head(SimSnapshot* snap) { snap->bus.queue_head = MAX_BUS_QUEUE; }
+static void bad_queue_count(SimSnapshot* snap) { snap->bus.queue_count++; }
+static void bad_dtc_count(SimSnapshot* snap) { snap->dtc.count = MAX_DTC_ENTRIES + 1; }
+static void bad_error_state(SimSnapshot* snap) { snap->ecus[1].err.state = (CANErrorState)7; }
+static void bad_ecu_count(SimSnapshot* snap) { snap->ecu_count = -1; }
+
+int main(void) {
+    SimSnapshot* snap = (SimSnapshot*)malloc(sizeof(SimSnapshot));
+    if (!snap) return 1;
+    
+    printf("=== Checkpoint Test ===\n\n");
+    
+    // Test 1: capture, save, map and restore give back the exact state
+    printf("Round trip:\n");
+    build_state();
+    SimEnv saved_env;
+    SIM_GetState(&saved_env);
+    uint64_t saved_rng = faults.rng;
+    uint64_t saved_bit_errors = faults.bit_errors;
+    saved_bus = bus;
+    memcpy(saved_ecus, ecus, sizeof(ecus));
+    saved_dtc = dtc;
+    
+    Checkpoint_Capture(snap, &bus, nodes, ECU_COUNT, &dtc, NULL, 123);
+    check(Checkpoint_Save(TEST_FILE, snap), "Image saved");
+    scramble_state();
+    
+    const SimSnapshot* image = Checkpoint_Map(TEST_FILE);
+    check(image != NULL, "Image mapped");
+    if (!image) {
+        remove(TEST_FILE);
+        return 1;
+    }
+    uint32_t cycle = 0;
+    check(Checkpoint_Restore(image, &bus, nodes, ECU_COUNT, &dtc, NULL, &cycle) && cycle == 123,
+          "Image restored at cycle 123");
+    
+    SimEnv env;
+    SIM_GetState(&env);
+    check(memcmp(&env, &saved_env, sizeof(env)) == 0, "SimEnv identical");
+    check(memcmp(&bus, &saved_bus, sizeof(bus)) == 0, "Bus identical");
+    check(memcmp(ecus, saved_ecus, sizeof(ecus)) == 0, "ECUs identical");
+    check(memcmp(&dtc, &saved_dtc, sizeof(dtc)) == 0, "DTCs identical");
+    check(faults.rng == saved_rng && faults.bit_errors == saved_bit_errors,
+          "Fault injector stream identical");
+    
+    // Test 2: intact checksum, impossible contents
+    printf("\nCorrupted images:\n");
+    check(!restore_copy(image, bad_queue_head), "Queue head out of range rejected");
+    check(!restore_copy(image, bad_queue_count), "Inconsistent queue count rejected");
+    check(!restore_copy(image, bad_dtc_count), "DTC count out of range rejected");
+    check(!restore_copy(image, bad_error_state), "Unknown ECU error state rejected");
+    check(!restore_copy(image, bad_ecu_count), "Negative ECU count rejected");
+    check(memcmp(&bus, &saved_bus, sizeof(bus)) == 0 &&
+          memcmp(&dtc, &saved_dtc, sizeof(dtc)) == 0, "Rejected images leave state alone");
+    Checkpoint_Unmap(image);
+    
+    // Test 3: a damaged file fails the checksum
+    FILE* file = fopen(TEST_FILE, "r+b");
+    if (file) {
+        fseek(file, (long)(sizeof(CheckpointHeader) + offsetof(SimSnapshot, dtc)), SEEK_SET);
+        fputc(0x5A, file);
+        fclose(file);
+    }
+    image = Checkpoint_Map(TEST_FILE);
+    check(file != NULL && image == NULL, "Damaged file rejected by checksum");
+    Checkpoint_Unmap(image);
+    
+    remove(TEST_FILE);
+    free(snap);
+    printf("\n%s (%d failure%s)\n", failures ? "FAILED" : "All tests passed",
+           failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
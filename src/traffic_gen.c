@@ -0,0 +1,411 @@
+#include "traffic_gen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define NS_PER_SEC 1000000000.0
+
+static uint64_t next_random(TrafficGen* gen) {
+    // xorshift64*
+    uint64_t x = gen->rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    gen->rng = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+void TGEN_Init(TrafficGen* gen, uint32_t bitrate, uint64_t seed) {
+    memset(gen, 0, sizeof(TrafficGen));
+    gen->bitrate = bitrate ? bitrate : TGEN_DEFAULT_BITRATE;
+    gen->rng = seed ? seed : 0x9E3779B97F4A7C15ULL;
+    memset(gen->id_stream, 0xFF, sizeof(gen->id_stream));
+}
+
+bool TGEN_AddStream(TrafficGen* gen, uint16_t id, uint8_t dlc, TGenMode mode,
+                    TGenPayload payload, double rate_hz, uint16_t burst_len, uint8_t node) {
+    if (gen->stream_count >= TGEN_MAX_STREAMS || rate_hz <= 0.0) {
+        printf("[TGEN] Error: Cannot add stream 0x%03X\n", id);
+        return false;
+    }
+
+    TGenStream* s = &gen->streams[gen->stream_count++];
+    memset(s, 0, sizeof(TGenStream));
+    s->id = id & 0x7FF;
+    s->dlc = (dlc > CAN_MAX_DATA_LEN) ? CAN_MAX_DATA_LEN : dlc;
+    s->mode = mode;
+    s->payload = payload;
+    s->rate_hz = rate_hz;
+    s->burst_len = (mode == TGEN_BURSTY && burst_len > 0) ? burst_len : 1;
+    s->node = node;
+    gen->id_node[s->id] = node;
+    if (gen->id_stream[s->id] == 0xFF) {
+        gen->id_stream[s->id] = (uint8_t)(gen->stream_count - 1);
+    }
+    return true;
+}
+
+// Index of name in names[], or -1
+static int lookup_name(const char* name, const char* const names[], int count) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(name, names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+// Parse an unsigned field that must be fully numeric and at most max
+static bool parse_field(const char* text, unsigned long max, unsigned long* value) {
+    char* end;
+    if (*text == '\0' || *text == '-') return false;
+    *value = strtoul(text, &end, 0);
+    return *end == '\0' && *value <= max;
+}
+
+// Stream from a command line spec, e.g. "0x200:8:periodic:100:ramp" or
+// "0x400:8:bursty:100:counter:8:2". Modes: periodic, bursty, poisson.
+// Payloads: constant, counter, ramp, random. burst_len defaults to 8 for
+// bursty streams; node defaults to the ID's priority band (0-3).
+bool TGEN_AddStreamSpec(TrafficGen* gen, const char* spec) {
+    static const char* const mode_names[] = {"periodic", "bursty", "poisson"};
+    static const char* const payload_names[] = {"constant", "counter", "ramp", "random"};
+    char buf[128];
+    char* fields[8];                // One spare to catch extra fields
+    int count = 0;
+
+    if (strlen(spec) >= sizeof(buf)) {
+        printf("[TGEN] Error: Stream spec too long: %s\n", spec);
+        return false;
+    }
+    strcpy(buf, spec);
+    for (char* p = buf; p && count < 8; ) {
+        fields[count++] = p;
+        p = strchr(p, ':');
+        if (p) *p++ = '\0';
+    }
+
+    unsigned long id, dlc, burst_len = 8, node = 0;
+    char* end;
+    double rate_hz = (count >= 5) ? strtod(fields[3], &end) : 0.0;
+    int mode = (count >= 5) ? lookup_name(fields[2], mode_names, 3) : -1;
+    int payload = (count >= 5) ? lookup_name(fields[4], payload_names, 4) : -1;
+    bool ok = count >= 5 && count <= 7 &&
+              parse_field(fields[0], 0x7FF, &id) &&
+              parse_field(fields[1], CAN_MAX_DATA_LEN, &dlc) &&
+              mode >= 0 && payload >= 0 &&
+              *end == '\0' && rate_hz > 0.0 &&
+              (count < 6 || (parse_field(fields[5], 0xFFFF, &burst_len) && burst_len > 0)) &&
+              (count < 7 || parse_field(fields[6], 0xFF, &node));
+    if (!ok) {
+        printf("[TGEN] Error: Bad stream spec '%s' (want id:dlc:mode:rate:payload[:burst[:node]])\n",
+               spec);
+        return false;
+    }
+    if (count < 7) {
+        node = (unsigned long)TGEN_PriorityClass((uint16_t)id);
+    }
+    return TGEN_AddStream(gen, (uint16_t)id, (uint8_t)dlc, (TGenMode)mode,
+                          (TGenPayload)payload, rate_hz, (uint16_t)burst_len, (uint8_t)node);
+}
+
+// A small vehicle network covering all four priority bands.
+// Nodes: 0 = engine, 1 = brake/chassis, 2 = body, 3 = infotainment
+void TGEN_AddDefaultStreams(TrafficGen* gen) {
+    TGEN_AddStream(gen, 0x050,                 8, TGEN_PERIODIC, TGEN_PAYLOAD_COUNTER, 100.0, 0, 0);
+    TGEN_AddStream(gen, CAN_ID_ENGINE_RPM,     8, TGEN_PERIODIC, TGEN_PAYLOAD_RAMP,     100.0, 0, 0);
+    TGEN_AddStream(gen, CAN_ID_VEHICLE_SPEED,  8, TGEN_PERIODIC, TGEN_PAYLOAD_RAMP,      50.0, 0, 1);
+    TGEN_AddStream(gen, CAN_ID_BRAKE_STATUS,   1, TGEN_PERIODIC, TGEN_PAYLOAD_CONSTANT,  50.0, 0, 1);
+    TGEN_AddStream(gen, CAN_ID_STEERING_ANGLE, 8, TGEN_PERIODIC, TGEN_PAYLOAD_RAMP,     100.0, 0, 1);
+    TGEN_AddStream(gen, CAN_ID_TEMPERATURE,    2, TGEN_PERIODIC, TGEN_PAYLOAD_RAMP,      10.0, 0, 0);
+    TGEN_AddStream(gen, CAN_ID_FUEL_LEVEL,     1, TGEN_PERIODIC, TGEN_PAYLOAD_RAMP,       1.0, 0, 0);
+    TGEN_AddStream(gen, CAN_ID_DOOR_STATUS,    1, TGEN_PERIODIC, TGEN_PAYLOAD_CONSTANT,  10.0, 0, 2);
+    TGEN_AddStream(gen, CAN_ID_LIGHTS_STATUS,  2, TGEN_PERIODIC, TGEN_PAYLOAD_CONSTANT,  10.0, 0, 2);
+    TGEN_AddStream(gen, 0x400,                 8, TGEN_BURSTY,   TGEN_PAYLOAD_COUNTER, 100.0, 8, 2);
+    TGEN_AddStream(gen, 0x500,                 8, TGEN_POISSON,  TGEN_PAYLOAD_RANDOM,  200.0, 0, 3);
+    TGEN_AddStream(gen, 0x600,                 8, TGEN_BURSTY,   TGEN_PAYLOAD_RANDOM,  200.0, 16, 3);
+    TGEN_AddStream(gen, CAN_ID_DIAGNOSTIC,     8, TGEN_POISSON,  TGEN_PAYLOAD_RANDOM,   20.0, 0, 3);
+}
+
+uint32_t TGEN_FrameBits(uint8_t dlc) {
+    return CAN_FRAME_BITS(dlc);
+}
+
+int TGEN_PriorityClass(uint16_t id) {
+    if (id < CAN_PRIORITY_HIGH) return 0;
+    if (id < CAN_PRIORITY_MEDIUM) return 1;
+    if (id < CAN_PRIORITY_LOW) return 2;
+    return 3;
+}
+
+double TGEN_OfferedLoad(const TrafficGen* gen) {
+    double bits_per_sec = 0.0;
+    for (int i = 0; i < gen->stream_count; i++) {
+        bits_per_sec += gen->streams[i].rate_hz * TGEN_FrameBits(gen->streams[i].dlc);
+    }
+    return bits_per_sec / gen->bitrate;
+}
+
+void TGEN_ScaleToUtilisation(TrafficGen* gen, double target) {
+    double current = TGEN_OfferedLoad(gen);
+    if (current <= 0.0) return;
+    for (int i = 0; i < gen->stream_count; i++) {
+        gen->streams[i].rate_hz *= target / current;
+    }
+}
+
+// Rewind all streams to t=0 (synchronous release, the worst case)
+void TGEN_Reset(TrafficGen* gen) {
+    for (int i = 0; i < gen->stream_count; i++) {
+        TGenStream* s = &gen->streams[i];
+        s->next_ns = 0;
+        s->interval_ns = (uint64_t)(NS_PER_SEC / s->rate_hz);
+        if (s->interval_ns == 0) s->interval_ns = 1;
+        s->burst_left = s->burst_len;
+        s->pending_head = 0;
+        s->pending_count = 0;
+        for (int b = 0; b < CAN_MAX_DATA_LEN; b++) {
+            s->data[b] = (uint8_t)(s->id + b);
+        }
+        s->ramp_base = (uint16_t)((s->data[0] << 8) | s->data[1]);
+    }
+}
+
+void TGEN_Next(TrafficGen* gen, CANFrame* frame, uint64_t* release_ns) {
+    TGenStream* s = &gen->streams[0];
+    for (int i = 1; i < gen->stream_count; i++) {
+        if (gen->streams[i].next_ns < s->next_ns) {
+            s = &gen->streams[i];
+        }
+    }
+
+    switch (s->payload) {
+        case TGEN_PAYLOAD_COUNTER:
+            s->data[0]++;
+            break;
+        case TGEN_PAYLOAD_RAMP: {
+            uint16_t value = (uint16_t)((s->data[0] << 8) | s->data[1]);
+            int step = (int)(next_random(gen) % 5) - 2;
+            int drift = (int16_t)(uint16_t)(value + step - s->ramp_base);
+            if (drift > TGEN_RAMP_RANGE || drift < -TGEN_RAMP_RANGE) step = -step;
+            value = (uint16_t)(value + step);
+            s->data[0] = (uint8_t)(value >> 8);
+            s->data[1] = (uint8_t)value;
+            break;
+        }
+        case TGEN_PAYLOAD_RANDOM: {
+            uint64_t r = next_random(gen);
+            memcpy(s->data, &r, sizeof(r));
+            break;
+        }
+        default:
+            break;
+    }
+
+    frame->id = s->id;
+    frame->dlc = s->dlc;
+    memcpy(frame->data, s->data, CAN_MAX_DATA_LEN);
+    frame->timestamp = (uint32_t)(s->next_ns / 1000);
+    frame->rtr = false;
+    frame->error = false;
+    *release_ns = s->next_ns;
+
+    switch (s->mode) {
+        case TGEN_BURSTY:
+            if (--s->burst_left == 0) {
+                s->burst_left = s->burst_len;
+                s->next_ns += s->interval_ns * s->burst_len;
+            }
+            break;
+        case TGEN_POISSON: {
+            double u = (double)(next_random(gen) >> 11) * (1.0 / 9007199254740992.0);
+            s->next_ns += (uint64_t)(-log(1.0 - u) * (double)s->interval_ns);
+            break;
+        }
+        default:
+            s->next_ns += s->interval_ns;
+            break;
+    }
+}
+
+// Frames of one ID leave the bus queue in the order they were queued, so the
+// 64-bit release times of queued frames are kept as a FIFO per ID
+static void push_pending(TrafficGen* gen, uint16_t id, uint64_t release_ns) {
+    TGenStream* s = &gen->streams[gen->id_stream[id]];
+    s->pending_ns[(s->pending_head + s->pending_count) % MAX_BUS_QUEUE] = release_ns;
+    s->pending_count++;
+}
+
+static uint64_t pop_pending(TrafficGen* gen, uint16_t id) {
+    TGenStream* s = &gen->streams[gen->id_stream[id]];
+    uint64_t release_ns = s->pending_ns[s->pending_head];
+    s->pending_head = (s->pending_head + 1) % MAX_BUS_QUEUE;
+    s->pending_count--;
+    return release_ns;
+}
+
+// Every node other than the sender sees the frame (or the error frame).
+// Bus-off nodes count the 11 recessive bits that end it towards recovery.
+static void update_receivers(ECUNode* nodes, int node_count, int sender, FaultType fault) {
+    for (int i = 0; i < node_count; i++) {
+        CANErrorCounters* err = &nodes[i].err;
+        if (err->state == CAN_BUS_OFF) {
+            CANERR_OnRecessiveSequence(err, 1);
+        } else if (i != sender) {
+            if (fault == FAULT_BIT_ERROR) {
+                CANERR_OnRxError(err);
+            } else if (fault == FAULT_NONE) {
+                CANERR_OnRxSuccess(err);
+            }
+        }
+    }
+}
+
+void TGEN_RunLoadTest(TrafficGen* gen, CANBus* bus, FaultInjector* faults,
+                      ECUNode* nodes, int node_count, uint64_t duration_ns, TGenReport* report) {
+    memset(report, 0, sizeof(TGenReport));
+    report->offered_load = TGEN_OfferedLoad(gen);
+    report->duration_ns = duration_ns;
+    TGEN_Reset(gen);
+
+    double bit_ns = NS_PER_SEC / gen->bitrate;
+    uint64_t frame_ns[CAN_MAX_DATA_LEN + 1];
+    for (int dlc = 0; dlc <= CAN_MAX_DATA_LEN; dlc++) {
+        frame_ns[dlc] = (uint64_t)(TGEN_FrameBits((uint8_t)dlc) * bit_ns);
+    }
+    if (!nodes) node_count = 0;
+
+    bool verbose = bus->verbose;
+    bus->verbose = false;
+    uint32_t dropped_start = bus->stats.dropped_frames;
+    uint32_t bus_off_start = 0;
+    for (int i = 0; i < node_count; i++) {
+        bus_off_start += nodes[i].err.bus_off_events;
+    }
+
+    uint64_t bus_free_ns = 0;
+    uint64_t busy_ns = 0;
+    uint64_t depth_sum = 0;
+    CANFrame frame, tx;
+    uint64_t release_ns;
+
+    for (;;) {
+        TGEN_Next(gen, &frame, &release_ns);
+        if (release_ns >= duration_ns) break;
+
+        // Transmit everything that wins the bus strictly before this
+        // release; frames released at the same instant all contend.
+        while (bus->queue_count > 0 && bus_free_ns < release_ns) {
+            CANBus_ReceiveArbitrated(bus, &tx);
+
+            int sender = gen->id_node[tx.id];
+            ECUNode* node = (sender < node_count) ? &nodes[sender] : NULL;
+            if (node && !CANERR_CanTransmit(&node->err)) {
+                pop_pending(gen, tx.id);
+                report->bus_off_drops++;
+                continue;
+            }
+
+            uint32_t error_bit = 0;
+            FaultType fault = faults ?
+                FAULT_Inject(faults, &tx, TGEN_FrameBits(tx.dlc), &error_bit) : FAULT_NONE;
+
+            if (fault != FAULT_NONE) {
+                // Attempt aborted at error_bit, then an error frame
+                uint64_t err_ns = (uint64_t)((error_bit + CAN_ERROR_FRAME_BITS) * bit_ns);
+                bus_free_ns += err_ns;
+                busy_ns += err_ns;
+                report->error_frames++;
+                report->error_bus_ns += err_ns;
+                bus->stats.errors++;
+
+                if (node) CANERR_OnTxError(&node->err, fault);
+                update_receivers(nodes, node_count, sender, fault);
+
+                if (node && !CANERR_CanTransmit(&node->err)) {
+                    pop_pending(gen, tx.id);
+                    report->bus_off_drops++;
+                } else if (!CANBus_Retransmit(bus, &tx)) {
+                    pop_pending(gen, tx.id);
+                }
+                continue;
+            }
+
+            bus_free_ns += frame_ns[tx.dlc];
+            busy_ns += frame_ns[tx.dlc];
+            if (node) CANERR_OnTxSuccess(&node->err);
+            update_receivers(nodes, node_count, sender, FAULT_NONE);
+            CANBus_Deliver(bus, &tx);
+
+            uint64_t latency_us = (bus_free_ns - pop_pending(gen, tx.id)) / 1000;
+            TGenLatency* lat = &report->latency[TGEN_PriorityClass(tx.id)];
+            lat->frames++;
+            lat->latency_sum_us += latency_us;
+            if (latency_us > lat->latency_max_us) lat->latency_max_us = latency_us;
+            report->delivered++;
+        }
+        if (bus->queue_count == 0 && bus_free_ns < release_ns) {
+            // Idle bus: every 11 recessive bits count towards bus-off recovery
+            uint32_t idle_sequences = (uint32_t)((release_ns - bus_free_ns) / (11.0 * bit_ns));
+            for (int i = 0; i < node_count && idle_sequences > 0; i++) {
+                CANERR_OnRecessiveSequence(&nodes[i].err, idle_sequences);
+            }
+            bus_free_ns = release_ns;
+        }
+
+        if (CANBus_Transmit(bus, &frame)) {
+            push_pending(gen, frame.id, release_ns);
+        }
+        report->generated++;
+        depth_sum += (uint64_t)bus->queue_count;
+        if (bus->queue_count > report->max_queue_depth) {
+            report->max_queue_depth = bus->queue_count;
+        }
+    }
+
+    report->carried_load = (double)busy_ns / (double)duration_ns;
+    report->dropped = bus->stats.dropped_frames - dropped_start;
+    report->avg_queue_depth = report->generated ?
+        (double)depth_sum / (double)report->generated : 0.0;
+    for (int i = 0; i < node_count; i++) {
+        report->bus_off_events += nodes[i].err.bus_off_events;
+    }
+    report->bus_off_events -= bus_off_start;
+    bus->verbose = verbose;
+}
+
+void TGEN_PrintReportHeader(void) {
+    printf("%7s %7s %10s %9s %6s %6s %4s %8s %6s %6s %7s  %-14s %-14s %-14s %-14s\n",
+           "Offered", "Carried", "Generated", "Dropped", "Drop%", "Qavg", "Qmax",
+           "ErrFrm", "ErrBW", "BusOff", "OffDrop",
+           "Critical(us)", "High(us)", "Medium(us)", "Low(us)");
+    printf("%7s %7s %10s %9s %6s %6s %4s %8s %6s %6s %7s  %-14s %-14s %-14s %-14s\n",
+           "", "", "", "", "", "", "", "", "", "", "",
+           "avg/max", "avg/max", "avg/max", "avg/max");
+}
+
+// Dropped covers queue overflows and frames discarded by bus-off nodes
+void TGEN_PrintReport(const TGenReport* report) {
+    uint64_t dropped = report->dropped + report->bus_off_drops;
+    printf("%6.0f%% %6.1f%% %10llu %9llu %5.1f%% %6.1f %4d ",
+           report->offered_load * 100.0, report->carried_load * 100.0,
+           (unsigned long long)report->generated, (unsigned long long)dropped,
+           report->generated ? 100.0 * dropped / (double)report->generated : 0.0,
+           report->avg_queue_depth, report->max_queue_depth);
+    printf("%8llu %5.1f%% %6u %7llu ",
+           (unsigned long long)report->error_frames,
+           report->duration_ns ? 100.0 * report->error_bus_ns / (double)report->duration_ns : 0.0,
+           report->bus_off_events, (unsigned long long)report->bus_off_drops);
+    for (int c = 0; c < TGEN_PRIORITY_CLASSES; c++) {
+        const TGenLatency* lat = &report->latency[c];
+        char cell[32];
+        if (lat->frames) {
+            snprintf(cell, sizeof(cell), "%llu/%llu",
+                     (unsigned long long)(lat->latency_sum_us / lat->frames),
+                     (unsigned long long)lat->latency_max_us);
+        } else {
+            snprintf(cell, sizeof(cell), "-");
+        }
+        printf(" %-14s", cell);
+    }
+    printf("\n");
+}